@@ -0,0 +1,967 @@
+/* Checkers engine library: board rules, move validation and minimax search.
+   See checkers_engine.h for the interface. Nothing in this file prints or
+   exits, and there is no global state.
+*/
+
+
+#include <stdlib.h>
+#include <limits.h>
+
+#include "checkers_engine.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+// costs of the rules
+#define COST_PIECE          1       // one piece cost
+#define COST_TOWER          3       // one tower cost
+#define DEPTH_0             0       //depth of the root of the minimax tree
+
+// steps of each direction, in rows and columns
+#define NE_ROWS             -1
+#define NE_COLS             1
+#define SE_ROWS             1
+#define SE_COLS             1
+#define SW_ROWS             1
+#define SW_COLS             -1
+#define NW_ROWS             -1
+#define NW_COLS             -1
+
+// direction a piece (not a tower) moves in: up the rows for white pieces,
+// down the rows for black pieces
+#define W_FORWARD           1
+#define B_FORWARD           -1
+
+#define ON_BOARD(row, col)  ((row)>=ROW_ONE && (row)<=ROW_EIGHT && \
+                             (col)>=COL_ONE && (col)<=COL_EIGHT)
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// Data stored in each node of the minimax tree
+typedef struct {
+    int        action;              //white or black action
+    int        leaf_cost;
+    int        depth;
+    int        s_row;               //source row
+    int        s_col;               //source column
+    int        t_row;               //target row
+    int        t_col;               //target column
+    board_t    poss_board;          //possible board state
+} data_t;
+
+// What perform_action_in_place() changed, so that it can be undone
+typedef struct {
+    unsigned char  moved;           //piece or tower that moved
+    unsigned char  captured;        //cell that was captured, if any
+    unsigned char  *promoted;       //cell promoted to a tower, or NULL
+} undo_t;
+
+// Node of the minimax tree
+typedef struct node node_t;
+struct node {
+    data_t    data;
+    node_t    *head_ND;             //head of the child node of next depth
+    node_t    *foot_ND;             //foot of the child node of next depth
+    node_t    *next_CD;             //next node in the current depth
+};
+
+
+/* function prototypes ------------------------------------------------------*/
+static int generate_moves(board_t board, int side,
+                          move_t moves[CHECKERS_MAX_MOVES]);
+static int black_moves(board_t board, move_t moves[CHECKERS_MAX_MOVES]);
+static int white_moves(board_t board, move_t moves[CHECKERS_MAX_MOVES]);
+static int black_action_rules(board_t board, int s_row, int s_col,
+                              int t_row, int t_col);
+static int white_action_rules(board_t board, int s_row, int s_col,
+                              int t_row, int t_col);
+static unsigned char *promotion_cell(board_t board);
+static void perform_action_in_place(board_t board, move_t *move,
+                                    undo_t *undo);
+static void undo_action(board_t board, move_t *move, undo_t *undo);
+static void tree_search(game_t *game, int depth, search_result_t *result);
+static void fused_search(game_t *game, int depth, search_result_t *result);
+static int  minimax(board_t board, int side, int depth, long *nodes);
+static node_t *make_empty_tree(void);
+static node_t *insert_at_foot(node_t *node, data_t *info);
+static void get_action(data_t *data, move_t *move, data_t *child_data,
+                       int max_depth);
+static int  fill_tree(node_t *tree, int max_depth);
+static void calculate_leaf_costs(node_t *tree, int max_depth);
+static long count_tree_nodes(node_t *tree);
+static void recursive_free_tree(node_t *tree);
+
+/* --------------------------------------------------------------------------*/
+
+/* Starts a new game from the initial board */
+void
+new_game(game_t *game) {
+    initialise_board(game->board);
+    game->action = 0;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Sets the game to the given board, with 'action' actions already made. The
+   board is taken as it is and is not checked.
+*/
+void
+set_board_position(game_t *game, board_t board, int action) {
+    copy_board(board, game->board);
+    game->action = action;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Starts a new game and plays the moves in order. Stops at the first illegal
+   move and returns its error number, or returns CHECKERS_LEGAL if all moves
+   were made. If 'n_played' is not NULL, it is set to the number of moves
+   made.
+*/
+int
+set_move_position(game_t *game, move_t *moves, int n_moves, int *n_played) {
+    int i, error_num=CHECKERS_LEGAL;
+
+    new_game(game);
+    for (i=0; i<n_moves; i++) {
+        error_num = play_move(game, &moves[i]);
+        if (error_num != CHECKERS_LEGAL) {
+            break;
+        }
+    }
+    if (n_played != NULL) {
+        *n_played = i;
+    }
+    return error_num;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns CHECKERS_BLACK if black makes the next action, CHECKERS_WHITE if
+   white does
+*/
+int
+side_to_move(game_t *game) {
+    return (game->action+1)%2;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Checks the move as the next action of the game. Returns CHECKERS_LEGAL,
+   or the error number of the first rule the move breaks.
+*/
+int
+validate_move(game_t *game, move_t *move) {
+    return is_legal_action(game->board, move->s_row, move->s_col,
+                           move->t_row, move->t_col, game->action+1);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes the move as the next action of the game if it is legal. Returns
+   CHECKERS_LEGAL, or the error number and leaves the game unchanged.
+*/
+int
+play_move(game_t *game, move_t *move) {
+    int error_num;
+
+    error_num = validate_move(game, move);
+    if (error_num == CHECKERS_LEGAL) {
+        perform_action(game->board, move);
+        game->action += 1;
+    }
+    return error_num;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Fills 'moves' with every legal action of the player to move, in the order
+   the minimax search considers them, and returns how many there are.
+*/
+int
+list_legal_moves(game_t *game, move_t moves[CHECKERS_MAX_MOVES]) {
+    return generate_moves(game->board, side_to_move(game), moves);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Fills 'config' with the default search: the fused engine, looking
+   CHECKERS_DEPTH actions ahead.
+*/
+void
+default_search_config(search_config_t *config) {
+    config->engine = CHECKERS_ENGINE_FUSED;
+    config->depth = CHECKERS_DEPTH;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Uses the minimax decision rule to compute the next action for the player
+   to move. The game itself is not changed. 'config' may be NULL for the
+   default search. The minimax engines all choose the same action. Engines
+   outside the library, such as the Monte Carlo one, are run by their own
+   functions instead.
+
+   Returns CHECKERS_WIN if the player has no action left (the opponent has
+   won), CHECKERS_ERROR_MEMORY if the search ran out of memory,
+   CHECKERS_ERROR_ENGINE if the engine is not one of the library's, and
+   CHECKERS_NOT_WIN otherwise. The same value is stored in result->status.
+*/
+int
+search_move(game_t *game, search_config_t *config,
+            search_result_t *result) {
+    search_config_t defaults;
+    int depth;
+
+    if (config == NULL) {
+        default_search_config(&defaults);
+        config = &defaults;
+    }
+    depth = config->depth < 1 ? 1 : config->depth;
+
+    if (config->engine == CHECKERS_ENGINE_TREE) {
+        tree_search(game, depth, result);
+    } else if (config->engine == CHECKERS_ENGINE_FUSED) {
+        fused_search(game, depth, result);
+    } else {
+        result->status = CHECKERS_ERROR_ENGINE;
+        result->nodes = result->memory = 0;
+    }
+    return result->status;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* The reference engine: builds the minimax tree of every board in the next
+   'depth' actions, then backs the leaf costs up to the root. If memory runs
+   out, the part of the tree already built is freed and the status is
+   CHECKERS_ERROR_MEMORY.
+*/
+static void
+tree_search(game_t *game, int depth, search_result_t *result) {
+    node_t *tree;             // points to the root of the data structure
+    node_t *curr;             // points to current node
+    node_t *chosen_child;     // points to the node with the final chosen board
+
+    //Create the data structure, and initialise the root
+    result->nodes = result->memory = 0;
+    tree = make_empty_tree();
+    if (tree == NULL) {
+        result->status = CHECKERS_ERROR_MEMORY;
+        return;
+    }
+    tree->data.action = side_to_move(game);
+    tree->data.depth = DEPTH_0;
+    copy_board(game->board, tree->data.poss_board);
+
+    //Compute all possible board states in the next turns.
+    //Then calculate the leaf costs based on the minimax decision rule
+    if (!fill_tree(tree, depth)) {
+        result->status = CHECKERS_ERROR_MEMORY;
+        recursive_free_tree(tree);
+        return;
+    }
+    calculate_leaf_costs(tree, depth);
+    result->nodes = count_tree_nodes(tree) - 1;
+    result->memory = (result->nodes+1)*sizeof(node_t) +
+                     depth*sizeof(move_t[CHECKERS_MAX_MOVES]);
+
+    //Check if the next depth (next action) exists. If not, a player has won.
+    if (tree->head_ND == NULL) {
+        result->status = CHECKERS_WIN;
+        recursive_free_tree(tree);
+        return;
+    }
+
+    //Next depth must exist. Find out what the best action is by comparing the
+    //board costs of the possible boards in depth 1. White wants the minimum
+    //board cost, black wants the maximum
+    curr = tree->head_ND;
+    chosen_child = curr;
+    while (curr) {
+        if ((tree->data.action == CHECKERS_WHITE &&
+             curr->data.leaf_cost < chosen_child->data.leaf_cost) ||
+            (tree->data.action == CHECKERS_BLACK &&
+             curr->data.leaf_cost > chosen_child->data.leaf_cost)) {
+            chosen_child = curr;
+        }
+        curr = curr->next_CD;
+    }
+
+    //found the best action (chosen_child)
+    result->status = CHECKERS_NOT_WIN;
+    result->move.s_row = chosen_child->data.s_row;
+    result->move.s_col = chosen_child->data.s_col;
+    result->move.t_row = chosen_child->data.t_row;
+    result->move.t_col = chosen_child->data.t_col;
+    result->score = chosen_child->data.leaf_cost;
+    result->board_cost = board_cost(chosen_child->data.poss_board);
+
+    recursive_free_tree(tree);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* The fused engine: walks the same tree depth first, making and undoing the
+   actions on one board, and keeps nothing but the best action of the root.
+   It visits the boards in the same order and breaks ties the same way as
+   tree_search(), so it chooses the same action, with memory that grows with
+   the depth rather than with the number of boards.
+*/
+static void
+fused_search(game_t *game, int depth, search_result_t *result) {
+    move_t moves[CHECKERS_MAX_MOVES];
+    board_t board;
+    undo_t undo;
+    int i, n_moves, side, cost, best=0;
+
+    copy_board(game->board, board);
+    side = side_to_move(game);
+    n_moves = generate_moves(board, side, moves);
+    result->nodes = n_moves;
+    result->memory = sizeof(board_t) +
+                     depth*(sizeof(move_t[CHECKERS_MAX_MOVES]) +
+                            sizeof(undo_t));
+    if (n_moves == 0) {
+        result->status = CHECKERS_WIN;
+        return;
+    }
+
+    //white wants the minimum board cost, black wants the maximum
+    for (i=0; i<n_moves; i++) {
+        perform_action_in_place(board, &moves[i], &undo);
+        cost = minimax(board, !side, depth-1, &result->nodes);
+        undo_action(board, &moves[i], &undo);
+        if (i == 0 || (side == CHECKERS_WHITE && cost < best) ||
+                      (side == CHECKERS_BLACK && cost > best)) {
+            best = cost;
+            result->move = moves[i];
+        }
+    }
+
+    result->status = CHECKERS_NOT_WIN;
+    result->score = best;
+    perform_action(board, &result->move);
+    result->board_cost = board_cost(board);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the minimax cost of the board, with 'side' to move and 'depth'
+   actions left to look at. As in calculate_leaf_costs(), a player with no
+   action left costs INT_MAX (white) or INT_MIN (black). 'nodes' counts the
+   boards generated.
+*/
+static int
+minimax(board_t board, int side, int depth, long *nodes) {
+    move_t moves[CHECKERS_MAX_MOVES];
+    undo_t undo;
+    int i, n_moves, cost, best;
+
+    if (depth == 0) {
+        return board_cost(board);
+    }
+    n_moves = generate_moves(board, side, moves);
+    *nodes += n_moves;
+    if (n_moves == 0) {
+        return side == CHECKERS_WHITE ? INT_MAX : INT_MIN;
+    }
+
+    best = side == CHECKERS_WHITE ? INT_MAX : INT_MIN;
+    for (i=0; i<n_moves; i++) {
+        perform_action_in_place(board, &moves[i], &undo);
+        cost = minimax(board, !side, depth-1, nodes);
+        undo_action(board, &moves[i], &undo);
+        if ((side == CHECKERS_WHITE && cost < best) ||
+            (side == CHECKERS_BLACK && cost > best)) {
+            best = cost;
+        }
+    }
+    return best;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* checks whether or not there is a piece that is supposed to be promoted in
+   the current board state. If there is, then promote the piece on the board.
+   Returns TRUE if something is promoted, FALSE if not.
+   This function assumes that pieces are on legal squares.
+*/
+int
+is_promotion(board_t board) {
+    unsigned char *cell;
+
+    cell = promotion_cell(board);
+    if (cell == NULL) {
+        //no promotions found
+        return FALSE;
+    }
+    *cell = (*cell == CHECKERS_BPIECE) ? CHECKERS_BTOWER : CHECKERS_WTOWER;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Finds the piece is_promotion() would promote: the first black piece in
+   row 1, or else the first white piece in row 8. Returns NULL if none.
+*/
+static unsigned char
+*promotion_cell(board_t board) {
+    int j;            //j+1 would be the column numbers from 1 to 8
+
+    //first, check if a black piece made it to row 1
+    for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+        if (board[ROW_ONE-1][j]==CHECKERS_BPIECE) {
+            return &board[ROW_ONE-1][j];
+        }
+    }
+    //then, check if a white piece made it to row 8
+    for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+        if (board[ROW_EIGHT-1][j]==CHECKERS_WPIECE) {
+            return &board[ROW_EIGHT-1][j];
+        }
+    }
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* This function initialises the checkers board at the start of the game */
+void
+initialise_board(board_t board) {
+    int i, j;     //i+1 would give the row number. j+1 would give column number
+
+    //fill board with empty cells
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+            board[i][j] = CHECKERS_EMPTY;
+        }
+    }
+
+    //initialise pieces at the start of the game
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        if (i+1==ROW_ONE || i+1==ROW_THREE) {
+            //white piece alternates every two columns, starting at column 2
+            for (j=1; j<CHECKERS_BOARD_SIZE; j+=2) {
+                board[i][j] = CHECKERS_WPIECE;
+            }
+        }
+        if (i+1==ROW_TWO) {
+            //white piece alternates, starting at column 1
+            for (j=0; j<CHECKERS_BOARD_SIZE; j+=2) {
+                board[i][j] = CHECKERS_WPIECE;
+            }
+        }
+        if (i+1==ROW_SIX || i+1==ROW_EIGHT) {
+            //black piece alternates, starting at column 1
+            for (j=0; j<CHECKERS_BOARD_SIZE; j+=2) {
+                board[i][j] = CHECKERS_BPIECE;
+            }
+        }
+        if (i+1==ROW_SEVEN) {
+            //black piece alternates, starting at column 2
+            for (j=1; j<CHECKERS_BOARD_SIZE; j+=2) {
+                board[i][j] = CHECKERS_BPIECE;
+            }
+        }
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Calculates the current board cost using the formula: 3B + b - 3W - w */
+int
+board_cost(board_t board) {
+    int i, j, cost=0;    //i+1 is the row number, j+1 is the column number
+
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+            if (board[i][j]==CHECKERS_BPIECE) {
+                cost += COST_PIECE;
+            } else if (board[i][j]==CHECKERS_WPIECE) {
+                cost -= COST_PIECE;
+            } else if (board[i][j]==CHECKERS_BTOWER) {
+                cost += COST_TOWER;
+            } else if (board[i][j]==CHECKERS_WTOWER) {
+                cost -= COST_TOWER;
+            }
+        }
+    }
+    return cost;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* This function takes the current board state, the coordinates of the source
+   cell and the target cell, as well as the current action number. Using these
+   values, it determines whether or not a move/capture is legal.
+   If the action is not legal, it will return the corresponding error number.
+*/
+int
+is_legal_action(board_t board, int s_row, int s_col, int t_row, int t_col, int action) {
+    char source_cell, target_cell;
+
+    //1. Source cell is outside of board
+    if (s_row<ROW_ONE || s_row>ROW_EIGHT || s_col<COL_ONE || s_col>COL_EIGHT) {
+        return CHECKERS_ERROR_1;
+    }
+
+    //2. Target cell is outside of board
+    if (t_row<ROW_ONE || t_row>ROW_EIGHT || t_col<COL_ONE || t_col>COL_EIGHT) {
+        return CHECKERS_ERROR_2;
+    }
+
+    source_cell = board[s_row-1][s_col-1];
+    target_cell = board[t_row-1][t_col-1];
+    //3. Source cell is empty
+    if (source_cell==CHECKERS_EMPTY) {
+        return CHECKERS_ERROR_3;
+    }
+
+    //4. Target cell is not empty
+    if (target_cell!=CHECKERS_EMPTY) {
+        return CHECKERS_ERROR_4;
+    }
+
+    //5. and 6. depend on whose action it is
+    if (action%2 == CHECKERS_BLACK) {
+        return black_action_rules(board, s_row, s_col, t_row, t_col);
+    }
+    return white_action_rules(board, s_row, s_col, t_row, t_col);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Defines the function that checks rules 5 and 6 of is_legal_action() for
+   one player, once the cells are known to be on the board, the source cell
+   to be full and the target cell to be empty. It is expanded once for black
+   and once for white, so every test against a player's pieces is a test
+   against a constant.
+*/
+#define ACTION_RULES(name, OWN_PIECE, OWN_TOWER, OPP_PIECE, OPP_TOWER,        \
+                     FORWARD)                                                 \
+static int                                                                    \
+name(board_t board, int s_row, int s_col, int t_row, int t_col) {             \
+    char cell_captured, source_cell;                                          \
+                                                                              \
+    source_cell = board[s_row-1][s_col-1];                                    \
+    /*5. Source cell holds opponent's piece/tower */                          \
+    if (source_cell==OPP_PIECE || source_cell==OPP_TOWER) {                   \
+        return CHECKERS_ERROR_5;                                              \
+    }                                                                         \
+                                                                              \
+    /*6. Other illegal actions */                                             \
+    /* a) Piece does not move diagonally */                                   \
+    if (abs(s_row-t_row) != abs(s_col-t_col)) {                               \
+        return CHECKERS_ERROR_6;                                              \
+    }                                                                         \
+    /* b) Piece jumps too far (greater than a distance of 2) */               \
+    if (abs(s_row-t_row)>MAX_DISTANCE || abs(s_col-t_col)>MAX_DISTANCE) {     \
+        return CHECKERS_ERROR_6;                                              \
+    }                                                                         \
+    /* c) Piece captures player's own piece, or captures nothing */           \
+    if (abs(s_row-t_row)==MAX_DISTANCE) {                                     \
+        cell_captured = board[(s_row+t_row)/2 - 1][(s_col+t_col)/2 - 1];      \
+        if (cell_captured == CHECKERS_EMPTY || cell_captured == OWN_PIECE ||  \
+            cell_captured == OWN_TOWER) {                                     \
+            return CHECKERS_ERROR_6;                                          \
+        }                                                                     \
+    }                                                                         \
+    /* d) Pieces moving backwards/capturing backwards */                      \
+    if (source_cell == OWN_PIECE && (t_row-s_row)*FORWARD < 0) {              \
+        return CHECKERS_ERROR_6;                                              \
+    }                                                                         \
+                                                                              \
+    /* No errors found, must be a legal move */                               \
+    return CHECKERS_LEGAL;                                                    \
+}
+
+ACTION_RULES(black_action_rules, CHECKERS_BPIECE, CHECKERS_BTOWER,
+             CHECKERS_WPIECE, CHECKERS_WTOWER, B_FORWARD)
+ACTION_RULES(white_action_rules, CHECKERS_WPIECE, CHECKERS_WTOWER,
+             CHECKERS_BPIECE, CHECKERS_BTOWER, W_FORWARD)
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes a move or a capture on the board, and promotes the piece to a tower
+   if needed. The move is assumed to be legal.
+*/
+void
+perform_action(board_t board, move_t *move) {
+    unsigned char *source_cell, *target_cell;
+
+    source_cell = &(board[move->s_row-1][move->s_col-1]);
+    target_cell = &(board[move->t_row-1][move->t_col-1]);
+    if (abs(move->s_col-move->t_col)==MAX_DISTANCE &&
+        abs(move->s_row-move->t_row)==MAX_DISTANCE) {
+        //this must be a capture move
+        board[(move->s_row+move->t_row)/2 - 1]
+             [(move->s_col+move->t_col)/2 - 1] = CHECKERS_EMPTY;
+    }
+    *target_cell = *source_cell;
+    *source_cell = CHECKERS_EMPTY;
+
+    //check whether a piece should be promoted to a tower.
+    is_promotion(board);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Does what perform_action() does, and remembers in 'undo' what changed */
+static void
+perform_action_in_place(board_t board, move_t *move, undo_t *undo) {
+    unsigned char *source_cell, *target_cell, *captured;
+
+    source_cell = &(board[move->s_row-1][move->s_col-1]);
+    target_cell = &(board[move->t_row-1][move->t_col-1]);
+    undo->moved = *source_cell;
+    if (abs(move->s_row-move->t_row)==MAX_DISTANCE) {
+        captured = &(board[(move->s_row+move->t_row)/2 - 1]
+                          [(move->s_col+move->t_col)/2 - 1]);
+        undo->captured = *captured;
+        *captured = CHECKERS_EMPTY;
+    }
+    *target_cell = *source_cell;
+    *source_cell = CHECKERS_EMPTY;
+
+    undo->promoted = promotion_cell(board);
+    if (undo->promoted != NULL) {
+        *undo->promoted = (*undo->promoted == CHECKERS_BPIECE) ? CHECKERS_BTOWER
+                                                           : CHECKERS_WTOWER;
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Puts the board back as it was before perform_action_in_place() */
+static void
+undo_action(board_t board, move_t *move, undo_t *undo) {
+    if (undo->promoted != NULL) {
+        *undo->promoted = (*undo->promoted == CHECKERS_BTOWER) ? CHECKERS_BPIECE
+                                                           : CHECKERS_WPIECE;
+    }
+    board[move->t_row-1][move->t_col-1] = CHECKERS_EMPTY;
+    board[move->s_row-1][move->s_col-1] = undo->moved;
+    if (abs(move->s_row-move->t_row)==MAX_DISTANCE) {
+        board[(move->s_row+move->t_row)/2 - 1]
+             [(move->s_col+move->t_col)/2 - 1] = undo->captured;
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Creates an empty data tree, and returns a pointer to the root node, or
+   NULL if there is no memory for it
+*/
+static node_t
+*make_empty_tree(void) {
+    node_t *root_node;
+    root_node = (node_t*)malloc(sizeof(*root_node));
+    if (root_node == NULL) {
+        return NULL;
+    }
+    root_node->head_ND = root_node->foot_ND = root_node->next_CD = NULL;
+    return root_node;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Creates a new node, and inserts the info into that new node. Then, insert
+   this new node into the foot of the next depth of 'node'. Returns NULL,
+   and leaves 'node' unchanged, if there is no memory for the new node.
+*/
+static node_t
+*insert_at_foot(node_t *node, data_t *info) {
+    node_t *new;
+
+    //make space for the new node and initialise some values/pointers
+    new = (node_t*)malloc(sizeof(*new));
+    if (new == NULL) {
+        return NULL;
+    }
+    new->data = *info;
+    new->head_ND = new->foot_ND = new->next_CD = NULL;
+
+    if (node->foot_ND == NULL) {
+        //this is the first insertion into the next depth
+        node->head_ND = node->foot_ND = new;
+    } else {
+        //not the first insertion into the next depth
+        node->foot_ND->next_CD = new;
+        node->foot_ND = new;
+    }
+    return node;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Copies all the cells of 'start_board' into the 'copied board'. */
+void
+copy_board(board_t start_board, board_t copied_board) {
+    int i, j;        //i+1 is the row number, j+1 is the column number
+
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+            copied_board[i][j] = start_board[i][j];
+        }
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Lists every legal action of the given player in row major order of the
+   source cells, trying the directions NE, SE, SW, NW for each. Returns the
+   number of actions.
+*/
+static int
+generate_moves(board_t board, int side, move_t moves[CHECKERS_MAX_MOVES]) {
+    if (side == CHECKERS_BLACK) {
+        return black_moves(board, moves);
+    }
+    return white_moves(board, moves);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Adds the action of the piece in 'cell' (at row, col) in one direction to
+   'moves', if there is one: a move if the next cell is empty, otherwise a
+   capture if the piece can jump over the next cell. Pieces (not towers)
+   never go backwards. These are the same rules is_legal_action() applies,
+   with the player and the direction fixed, and it finds the same action
+   the old one-direction-at-a-time search did.
+*/
+#define TRY_DIRECTION(ROWS, COLS, OWN_PIECE, OWN_TOWER, FORWARD)              \
+    if (cell != OWN_PIECE || ROWS == FORWARD) {                               \
+        t_row = row + (ROWS);                                                 \
+        t_col = col + (COLS);                                                 \
+        if (ON_BOARD(t_row, t_col)) {                                         \
+            next_cell = board[t_row-1][t_col-1];                              \
+            if (next_cell == CHECKERS_EMPTY) {                                \
+                moves[n_moves].s_row = row;                                   \
+                moves[n_moves].s_col = col;                                   \
+                moves[n_moves].t_row = t_row;                                 \
+                moves[n_moves].t_col = t_col;                                 \
+                n_moves++;                                                    \
+            } else if (next_cell != OWN_PIECE && next_cell != OWN_TOWER &&    \
+                       ON_BOARD(t_row+(ROWS), t_col+(COLS)) &&                \
+                       board[t_row+(ROWS)-1][t_col+(COLS)-1] ==               \
+                       CHECKERS_EMPTY) {                                      \
+                moves[n_moves].s_row = row;                                   \
+                moves[n_moves].s_col = col;                                   \
+                moves[n_moves].t_row = t_row + (ROWS);                        \
+                moves[n_moves].t_col = t_col + (COLS);                        \
+                n_moves++;                                                    \
+            }                                                                 \
+        }                                                                     \
+    }
+
+/* Defines the move generator of one player. Every cell that is neither
+   empty nor the opponent's is tried in each of the four directions, with
+   the player and the direction steps written in as constants.
+*/
+#define MOVE_GENERATOR(name, OWN_PIECE, OWN_TOWER, OPP_PIECE, OPP_TOWER,      \
+                       FORWARD)                                               \
+static int                                                                    \
+name(board_t board, move_t moves[CHECKERS_MAX_MOVES]) {                       \
+    int row, col, t_row, t_col, n_moves=0;                                    \
+    unsigned char cell, next_cell;                                            \
+                                                                              \
+    for (row=ROW_ONE; row<=ROW_EIGHT; row++) {                                \
+        for (col=COL_ONE; col<=COL_EIGHT; col++) {                            \
+            cell = board[row-1][col-1];                                       \
+            if (cell == CHECKERS_EMPTY || cell == OPP_PIECE ||                \
+                cell == OPP_TOWER) {                                          \
+                continue;                                                     \
+            }                                                                 \
+            TRY_DIRECTION(NE_ROWS, NE_COLS, OWN_PIECE, OWN_TOWER, FORWARD)    \
+            TRY_DIRECTION(SE_ROWS, SE_COLS, OWN_PIECE, OWN_TOWER, FORWARD)    \
+            TRY_DIRECTION(SW_ROWS, SW_COLS, OWN_PIECE, OWN_TOWER, FORWARD)    \
+            TRY_DIRECTION(NW_ROWS, NW_COLS, OWN_PIECE, OWN_TOWER, FORWARD)    \
+        }                                                                     \
+    }                                                                         \
+    return n_moves;                                                           \
+}
+
+MOVE_GENERATOR(black_moves, CHECKERS_BPIECE, CHECKERS_BTOWER,
+               CHECKERS_WPIECE, CHECKERS_WTOWER, B_FORWARD)
+MOVE_GENERATOR(white_moves, CHECKERS_WPIECE, CHECKERS_WTOWER,
+               CHECKERS_BPIECE, CHECKERS_BTOWER, W_FORWARD)
+
+/* --------------------------------------------------------------------------*/
+
+/* - Takes the data about a current turn, and one of its legal actions.
+   - Stores the data of the turn after that action in 'child_data'.
+   - This function also calculates the board cost, if the children board is in
+     the last depth.
+*/
+static void
+get_action(data_t *data, move_t *move, data_t *child_data, int max_depth) {
+    //copy the board across, then make move/capture and promote if needed
+    copy_board(data->poss_board, child_data->poss_board);
+    perform_action(child_data->poss_board, move);
+
+    //make other changes for the child_data, as it describes the next turn
+    if (data->action == CHECKERS_WHITE) {
+        //was white's move. Next turn will be black's move
+        child_data->action = CHECKERS_BLACK;
+    } else {
+        //was black's move. Next turn will be white's move
+        child_data->action = CHECKERS_WHITE;
+    }
+    child_data->depth = data->depth + 1;
+
+    //store the coordinates of the source cell and the target cell
+    child_data->s_row = move->s_row;
+    child_data->s_col = move->s_col;
+    child_data->t_row = move->t_row;
+    child_data->t_col = move->t_col;
+
+    //if child_data is in the last depth, calculate the board cost as well
+    if (child_data->depth == max_depth) {
+        child_data->leaf_cost = board_cost(child_data->poss_board);
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Takes a node of the tree, and using the data stored in that node, compute
+   all the possible actions down to 'max_depth'. Store these possible actions
+   into the tree. Returns FALSE if memory ran out; the nodes made until then
+   stay in the tree, to be freed with it.
+*/
+static int
+fill_tree(node_t *tree, int max_depth) {
+    move_t moves[CHECKERS_MAX_MOVES];  //possible actions, in row major order
+    data_t child_data;        //data that stores the next possible action
+    int i, n_moves;
+
+    if (tree->data.depth == max_depth) {
+        //do nothing
+        return TRUE;
+    }
+
+    //not the last depth, can look for possible actions
+    n_moves = generate_moves(tree->data.poss_board, tree->data.action, moves);
+    for (i=0; i<n_moves; i++) {
+        get_action(&tree->data, &moves[i], &child_data, max_depth);
+        if (insert_at_foot(tree, &child_data) == NULL) {
+            return FALSE;
+        }
+        //recursively call the function again for the next depth
+        if (!fill_tree(tree->foot_ND, max_depth)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Uses the minimax decision rule to calculate leaf costs for boards from
+   the depth above 'max_depth', upwards to depth 0.
+*/
+static void
+calculate_leaf_costs(node_t *tree, int max_depth) {
+    node_t *curr;
+    int max, min;
+
+    //if at the last depth, don't need to do anything as the cost was already
+    //found.
+    if (tree->data.depth == max_depth) {
+        return;
+    }
+
+    //Not the last depth. Check if the next action exists
+    if (tree->head_ND == NULL) {
+        //next action does not exist. A player wins here
+        if (tree->data.action == CHECKERS_WHITE) {
+            //white has no action. So cost is INT_MAX
+            tree->data.leaf_cost = INT_MAX;
+        } else {
+            //black has no action. So cost is INT_MIN
+            tree->data.leaf_cost = INT_MIN;
+        }
+        return;
+    }
+
+    //Now we know that next depth exists
+    curr = tree->head_ND;
+    while (curr) {
+        //recursive call to function, to go to the deepest nodes first
+        calculate_leaf_costs(curr, max_depth);
+        curr = curr->next_CD;
+    }
+
+    //walk along the next depth to propagate leaf cost upwards
+    if (tree->data.action == CHECKERS_BLACK) {
+        //black's action, want to find max cost
+        curr = tree->head_ND;
+        max = curr->data.leaf_cost;
+        while (curr) {
+            if (curr->data.leaf_cost > max) {
+                max = curr->data.leaf_cost;
+            }
+            curr = curr->next_CD;
+        }
+        tree->data.leaf_cost = max;
+    }
+    if (tree->data.action == CHECKERS_WHITE) {
+        //white's action, want to find min cost
+        curr = tree->head_ND;
+        min = curr->data.leaf_cost;
+        while (curr) {
+            if (curr->data.leaf_cost < min) {
+                min = curr->data.leaf_cost;
+            }
+            curr = curr->next_CD;
+        }
+        tree->data.leaf_cost = min;
+    }
+
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Counts the nodes of the tree, including the root. */
+static long
+count_tree_nodes(node_t *tree) {
+    node_t *curr;
+    long count=1;
+
+    for (curr=tree->head_ND; curr; curr=curr->next_CD) {
+        count += count_tree_nodes(curr);
+    }
+    return count;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Frees the memory space allocated for the tree. */
+static void
+recursive_free_tree(node_t *tree) {
+    node_t *curr, *prev;
+
+    curr = tree->head_ND;
+    while (curr) {
+        prev = curr;
+        curr = curr->next_CD;
+        recursive_free_tree(prev);
+    }
+    free(tree);
+    return;
+}
+
+/* THE END -------------------------------------------------------------------*/
@@ -0,0 +1,125 @@
+/* Checkers engine library: the board rules, move validation, move listing
+   and the minimax search, with no global state and no I/O.
+
+   All the state of a game lives in a game_t owned by the caller, so any
+   number of games can be played or searched at the same time.
+*/
+
+#ifndef CHECKERS_ENGINE_H
+#define CHECKERS_ENGINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+// Every name here starts with CHECKERS_, so that the header can be included
+// anywhere. The rest of the constants of the rules are kept in the files
+// that use them.
+
+// the board
+#define CHECKERS_BOARD_SIZE     8       // board size
+#define CHECKERS_EMPTY          '.'     // empty cell character
+#define CHECKERS_BPIECE         'b'     // black piece character
+#define CHECKERS_WPIECE         'w'     // white piece character
+#define CHECKERS_BTOWER         'B'     // black tower character
+#define CHECKERS_WTOWER         'W'     // white tower character
+#define CHECKERS_MAX_MOVES      128     // most actions possible from one board
+
+// the players, as returned by side_to_move()
+#define CHECKERS_BLACK          1       //black's action
+#define CHECKERS_WHITE          0       //white's action
+
+// search engines
+#define CHECKERS_ENGINE_TREE    0       //builds the whole minimax tree first
+#define CHECKERS_ENGINE_FUSED   1       //depth-first on one board, no tree
+#define CHECKERS_ENGINE_MCTS    2       //Monte Carlo, see mcts_search.h;
+                                        //not run by search_move()
+#define CHECKERS_DEPTH          3       //default minimax tree depth
+
+// errors and legal moves
+#define CHECKERS_ERROR_1        1       //source cell is outside of the board
+#define CHECKERS_ERROR_2        2       //target cell is outside of the board
+#define CHECKERS_ERROR_3        3       //source cell is empty
+#define CHECKERS_ERROR_4        4       //target cell is not empty
+#define CHECKERS_ERROR_5        5       //source cell holds opponent's piece
+#define CHECKERS_ERROR_6        6       //illegal action
+#define CHECKERS_LEGAL          7       //Move is legal
+
+// results of a search
+#define CHECKERS_WIN            0       //the player to move has no action
+#define CHECKERS_NOT_WIN        1       //an action was chosen
+#define CHECKERS_ERROR_MEMORY   2       //the search ran out of memory
+#define CHECKERS_ERROR_ENGINE   3       //search_move() has no such engine
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+typedef unsigned char board_t[CHECKERS_BOARD_SIZE][CHECKERS_BOARD_SIZE];
+// board[row-1][col-1] will describe the squares on the board
+
+// One action, using the row and column numbers of the board (1-8)
+typedef struct {
+    int        s_row;               //source row
+    int        s_col;               //source column
+    int        t_row;               //target row
+    int        t_col;               //target column
+} move_t;
+
+// A game in progress
+typedef struct {
+    board_t    board;               //current board state
+    int        action;              //number of actions made so far
+} game_t;
+
+// How to search
+typedef struct {
+    int        engine;              //one of the CHECKERS_ENGINE_* engines
+    int        depth;               //actions looked ahead, at least 1
+} search_config_t;
+
+// What a search found for the player to move
+typedef struct {
+    int        status;              //CHECKERS_WIN if the player has no action,
+                                    //or a CHECKERS_ERROR_* if it failed
+    move_t     move;                //the chosen action
+    int        score;               //backed-up minimax cost of the action
+                                    //(MCTS: mean cost its playouts ended on)
+    int        board_cost;          //board cost after the chosen action
+    long       nodes;               //number of boards the search generated,
+                                    //0 if the result came from a cache
+    long       memory;              //most bytes of boards, tree nodes and
+                                    //action lists the search held at once
+} search_result_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+
+// board rules
+void initialise_board(board_t board);
+void copy_board(board_t start_board, board_t copied_board);
+int  board_cost(board_t board);
+int  is_promotion(board_t board);
+int  is_legal_action(board_t board, int s_row, int s_col,
+                     int t_row, int t_col, int action);
+void perform_action(board_t board, move_t *move);
+
+// games
+void new_game(game_t *game);
+void set_board_position(game_t *game, board_t board, int action);
+int  set_move_position(game_t *game, move_t *moves, int n_moves,
+                       int *n_played);
+int  side_to_move(game_t *game);
+int  validate_move(game_t *game, move_t *move);
+int  play_move(game_t *game, move_t *move);
+int  list_legal_moves(game_t *game, move_t moves[CHECKERS_MAX_MOVES]);
+void default_search_config(search_config_t *config);
+int  search_move(game_t *game, search_config_t *config,
+                 search_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
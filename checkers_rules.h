@@ -0,0 +1,33 @@
+/* Constants of the rules and of the board, shared by the files of this
+   program. This header is internal: it is not part of the engine's public
+   interface (checkers_engine.h), and is not installed with it, so its
+   names need no prefix.
+*/
+
+#ifndef CHECKERS_RULES_H
+#define CHECKERS_RULES_H
+
+/* Definitions ------------------------------------------------------*/
+
+// directions and distances of an action
+#define NE                  1       //North-East direction
+#define SE                  2       //South-East direction
+#define SW                  3       //South-West direction
+#define NW                  4       //North-West direction
+#define MAX_DISTANCE        2       //max distance a piece can move in one turn
+#define MOVE_DISTANCE       1       //moving distance of a piece (not capture)
+
+// useful row numbers and column numbers
+#define ROW_ONE             1
+#define ROW_TWO             2
+#define ROW_THREE           3
+#define ROW_SIX             6
+#define ROW_SEVEN           7
+#define ROW_EIGHT           8
+#define COL_ONE             1
+#define COL_EIGHT           8
+
+#define TRUE                1
+#define FALSE               0
+
+#endif
@@ -0,0 +1,536 @@
+/* Side by side comparison of two search engines.
+   See engine_compare.h for what is compared.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine_compare.h"
+#include "game_record.h"
+#include "search_util.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+// kinds of difference, from the most to the least important
+#define NO_DIFFERENCE       0
+#define DIFF_MEMORY         1       //an engine ran out of memory
+#define DIFF_LEGALITY       2       //the rules differ from the original ones
+#define DIFF_ILLEGAL        3       //an engine chose an illegal action
+#define DIFF_STATUS         4       //only one engine found the player lost
+#define DIFF_MOVE           5       //different chosen actions
+#define DIFF_SCORE          6       //different backed-up costs
+#define DIFF_BOARD_COST     7       //different board costs after the action
+#define DIFFERENCE_NAMES    {"none", "memory", "legal action list", \
+                             "illegal action", "win verdict", \
+                             "chosen action", "backed-up cost", "board cost"}
+
+#define DEFAULT_SEED        88172645463325252ULL
+#define BYTES_PER_KB        1024
+
+
+/* function prototypes ------------------------------------------------------*/
+static int  compare_position(search_options_t configs[2], game_t *game,
+                             search_result_t results[2],
+                             compare_report_t *report);
+static int  legality_agrees(game_t *game);
+static int  original_moves(game_t *game,
+                           move_t moves[CHECKERS_MAX_MOVES]);
+static int  original_action(board_t board, int s_row, int s_col,
+                            int direction, int action, move_t *move);
+static int  original_legal_action(board_t board, int s_row, int s_col,
+                                  int t_row, int t_col, int action);
+static int  same_move(move_t *a, move_t *b);
+static void shrink_position(search_options_t configs[2], game_t *game);
+static void report_difference(FILE *out, char *names[2], char *source,
+                              int number, int kind,
+                              search_options_t configs[2], game_t *game,
+                              search_result_t results[2]);
+static void write_result(FILE *out, char *name, search_result_t *result);
+static void random_position(game_t *game, unsigned long long *state);
+
+/* --------------------------------------------------------------------------*/
+
+/* Searches 'n_random' random positions (made from 'seed'), then every
+   position of each text game, with both engines, and writes every
+   difference and the totals to 'out'. The engines are searched without a
+   cache, so that the times are those of the engines themselves.
+*/
+int
+compare_engines(search_options_t configs[2], char *names[2],
+                int n_random, unsigned long seed,
+                char *game_paths[], int n_games,
+                FILE *out, compare_report_t *report) {
+    search_options_t uncached[2];
+    search_result_t results[2];
+    unsigned long long state;
+    char source[BUFSIZ];
+    game_t game;
+    move_t *moves;
+    FILE *fp;
+    int i, g, kind, n_moves, status=COMPARE_SAME;
+
+    memset(report, 0, sizeof(*report));
+    for (i=0; i<2; i++) {
+        uncached[i] = configs[i];
+        uncached[i].cache = NULL;
+    }
+    fprintf(out, "COMPARING %s WITH %s, DEPTH %d AND %d\n", names[0],
+            names[1], uncached[0].depth, uncached[1].depth);
+
+    //random positions
+    state = seed ? seed : DEFAULT_SEED;
+    for (i=0; i<n_random; i++) {
+        random_position(&game, &state);
+        kind = compare_position(uncached, &game, results, report);
+        if (kind != NO_DIFFERENCE) {
+            snprintf(source, sizeof(source), "random position %d", i);
+            report_difference(out, names, source, report->n_differences,
+                              kind, uncached, &game, results);
+        }
+    }
+
+    //every position of the games, stopping at an illegal action
+    for (g=0; g<n_games; g++) {
+        fp = fopen(game_paths[g], "r");
+        if (fp == NULL || read_text_game(fp, &moves, &n_moves) != RECORD_OK) {
+            fprintf(out, "%s: cannot read the game\n", game_paths[g]);
+            if (fp != NULL) {
+                fclose(fp);
+            }
+            status = COMPARE_ERROR_GAME;
+            continue;
+        }
+        fclose(fp);
+        new_game(&game);
+        for (i=0; i<=n_moves; i++) {
+            kind = compare_position(uncached, &game, results, report);
+            if (kind != NO_DIFFERENCE) {
+                snprintf(source, sizeof(source), "%s after action %d",
+                         game_paths[g], i);
+                report_difference(out, names, source, report->n_differences,
+                                  kind, uncached, &game, results);
+            }
+            if (i < n_moves && play_move(&game, &moves[i]) != CHECKERS_LEGAL) {
+                fprintf(out, "%s: action %d is illegal, rest of the game "
+                        "skipped\n", game_paths[g], i+1);
+                status = COMPARE_ERROR_GAME;
+                break;
+            }
+        }
+        free(moves);
+    }
+
+    //totals, and how the second engine did against the first
+    fprintf(out, "POSITIONS: %d\n", report->n_positions);
+    fprintf(out, "DIFFERENCES: %d\n", report->n_differences);
+    for (i=0; i<2; i++) {
+        fprintf(out, "%s: %.6f s, %lld boards, %ld KB at most\n", names[i],
+                report->totals[i].seconds, report->totals[i].nodes,
+                (report->totals[i].memory + BYTES_PER_KB-1)/BYTES_PER_KB);
+    }
+    if (report->totals[0].seconds > 0 && report->totals[0].memory > 0) {
+        fprintf(out, "%s TOOK %.3f TIMES THE TIME AND %.3f TIMES THE MEMORY "
+                "OF %s\n", names[1],
+                report->totals[1].seconds/report->totals[0].seconds,
+                (double)report->totals[1].memory/report->totals[0].memory,
+                names[0]);
+    }
+
+    if (status == COMPARE_SAME && report->n_differences > 0) {
+        status = COMPARE_DIFFERENT;
+    }
+    return status;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Searches the position with both engines, and returns the most important
+   kind of difference, or NO_DIFFERENCE. If 'report' is not NULL, the
+   searches are added to its totals.
+*/
+static int
+compare_position(search_options_t configs[2], game_t *game,
+                 search_result_t results[2], compare_report_t *report) {
+    double start;
+    int i, kind=NO_DIFFERENCE;
+
+    for (i=0; i<2; i++) {
+        start = now_seconds();
+        run_search(game, &configs[i], &results[i]);
+        if (report != NULL) {
+            report->totals[i].seconds += now_seconds() - start;
+            report->totals[i].nodes += results[i].nodes;
+            if (results[i].memory > report->totals[i].memory) {
+                report->totals[i].memory = results[i].memory;
+            }
+        }
+    }
+
+    if (results[0].status == CHECKERS_ERROR_MEMORY ||
+        results[1].status == CHECKERS_ERROR_MEMORY) {
+        kind = DIFF_MEMORY;
+    } else if (!legality_agrees(game)) {
+        kind = DIFF_LEGALITY;
+    } else if ((results[0].status == CHECKERS_NOT_WIN &&
+                validate_move(game, &results[0].move) != CHECKERS_LEGAL) ||
+               (results[1].status == CHECKERS_NOT_WIN &&
+                validate_move(game, &results[1].move) != CHECKERS_LEGAL)) {
+        kind = DIFF_ILLEGAL;
+    } else if (results[0].status != results[1].status) {
+        kind = DIFF_STATUS;
+    } else if (results[0].status == CHECKERS_WIN) {
+        kind = NO_DIFFERENCE;
+    } else if (!same_move(&results[0].move, &results[1].move)) {
+        kind = DIFF_MOVE;
+    } else if (results[0].score != results[1].score) {
+        kind = DIFF_SCORE;
+    } else if (results[0].board_cost != results[1].board_cost) {
+        kind = DIFF_BOARD_COST;
+    }
+
+    if (report != NULL) {
+        report->n_positions++;
+        if (kind != NO_DIFFERENCE) {
+            report->n_differences++;
+        }
+    }
+    return kind;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Checks the rules of the engine against the original ones, frozen below,
+   which the engine's move generator and is_legal_action() were rewritten
+   from: is_legal_action() must give the same answer as the original for
+   every cell two rows and columns around each source, and the generator
+   must list the same actions, in the same order, as the original search.
+   Testing the generator against the engine's own is_legal_action() would
+   miss a change both of them share.
+*/
+static int
+legality_agrees(game_t *game) {
+    move_t moves[CHECKERS_MAX_MOVES], original[CHECKERS_MAX_MOVES], move;
+    int i, n_moves;
+
+    for (move.s_row=ROW_ONE; move.s_row<=ROW_EIGHT; move.s_row++) {
+        for (move.s_col=COL_ONE; move.s_col<=COL_EIGHT; move.s_col++) {
+            for (move.t_row=move.s_row-MAX_DISTANCE;
+                 move.t_row<=move.s_row+MAX_DISTANCE; move.t_row++) {
+                for (move.t_col=move.s_col-MAX_DISTANCE;
+                     move.t_col<=move.s_col+MAX_DISTANCE; move.t_col++) {
+                    if (validate_move(game, &move) !=
+                        original_legal_action(game->board, move.s_row,
+                                              move.s_col, move.t_row,
+                                              move.t_col, game->action+1)) {
+                        return FALSE;
+                    }
+                }
+            }
+        }
+    }
+
+    n_moves = list_legal_moves(game, moves);
+    if (n_moves != original_moves(game, original)) {
+        return FALSE;
+    }
+    for (i=0; i<n_moves; i++) {
+        if (!same_move(&moves[i], &original[i])) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Lists the actions of the player to move as the original search found
+   them: the cells in row-major order, and for each, the directions NE, SE,
+   SW and NW. Returns the number of actions.
+*/
+static int
+original_moves(game_t *game, move_t moves[CHECKERS_MAX_MOVES]) {
+    int row, col, direction, n_moves=0;
+
+    for (row=ROW_ONE; row<=ROW_EIGHT; row++) {
+        for (col=COL_ONE; col<=COL_EIGHT; col++) {
+            if (game->board[row-1][col-1] == CHECKERS_EMPTY) {
+                continue;
+            }
+            for (direction=NE; direction<=NW; direction++) {
+                if (n_moves < CHECKERS_MAX_MOVES &&
+                    original_action(game->board, row, col, direction,
+                                    game->action+1, &moves[n_moves])) {
+                    n_moves++;
+                }
+            }
+        }
+    }
+    return n_moves;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* The original get_action(), without the tree: finds the action of the
+   piece in the source cell in one direction, a move first and else a
+   capture. Returns TRUE and fills 'move' if there is one. Kept as it was,
+   to test the engine against; do not change it with the engine.
+*/
+static int
+original_action(board_t board, int s_row, int s_col, int direction,
+                int action, move_t *move) {
+    int t_row, t_col;        //coordinates of the target cell
+    int action_found=FALSE;
+
+    //check the given direction for moves (not captures) fist
+    if (direction == NE) {
+        t_row = s_row - MOVE_DISTANCE;
+        t_col = s_col + MOVE_DISTANCE;
+    } else if (direction == SE) {
+        t_row = s_row + MOVE_DISTANCE;
+        t_col = s_col + MOVE_DISTANCE;
+    } else if (direction == SW) {
+        t_row = s_row + MOVE_DISTANCE;
+        t_col = s_col - MOVE_DISTANCE;
+    } else {
+        t_row = s_row - MOVE_DISTANCE;
+        t_col = s_col - MOVE_DISTANCE;
+    }
+    if (original_legal_action(board, s_row, s_col,
+        t_row, t_col, action) == CHECKERS_LEGAL) {
+        //legal action found. And it is a move, not a capture
+        action_found = TRUE;
+    }
+
+    //next, if no moves were found, check the given direction for captures
+    if (direction == NE && !action_found) {
+        t_row = s_row - MAX_DISTANCE;
+        t_col = s_col + MAX_DISTANCE;
+    } else if (direction == SE && !action_found) {
+        t_row = s_row + MAX_DISTANCE;
+        t_col = s_col + MAX_DISTANCE;
+    } else if (direction == SW && !action_found) {
+        t_row = s_row + MAX_DISTANCE;
+        t_col = s_col - MAX_DISTANCE;
+    } else if (direction == NW && !action_found) {
+        t_row = s_row - MAX_DISTANCE;
+        t_col = s_col - MAX_DISTANCE;
+    }
+    if (original_legal_action(board, s_row, s_col,
+        t_row, t_col, action) == CHECKERS_LEGAL) {
+        //legal action found. It is a capture move
+        action_found = TRUE;
+    }
+
+    if (action_found) {
+        move->s_row = s_row;
+        move->s_col = s_col;
+        move->t_row = t_row;
+        move->t_col = t_col;
+    }
+    return action_found;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* The original is_legal_action(): returns CHECKERS_LEGAL, or the number of
+   the first rule the action breaks. 'action' is even for white. Kept as it
+   was, to test the engine against; do not change it with the engine.
+*/
+static int
+original_legal_action(board_t board, int s_row, int s_col, int t_row,
+                      int t_col, int action) {
+    char cell_captured, source_cell, target_cell;
+
+    //1. Source cell is outside of board
+    if (s_row<ROW_ONE || s_row>ROW_EIGHT || s_col<COL_ONE || s_col>COL_EIGHT) {
+        return CHECKERS_ERROR_1;
+    }
+
+    //2. Target cell is outside of board
+    if (t_row<ROW_ONE || t_row>ROW_EIGHT || t_col<COL_ONE || t_col>COL_EIGHT) {
+        return CHECKERS_ERROR_2;
+    }
+
+    source_cell = board[s_row-1][s_col-1];
+    target_cell = board[t_row-1][t_col-1];
+    //3. Source cell is empty
+    if (source_cell==CHECKERS_EMPTY) {
+        return CHECKERS_ERROR_3;
+    }
+
+    //4. Target cell is not empty
+    if (target_cell!=CHECKERS_EMPTY) {
+        return CHECKERS_ERROR_4;
+    }
+
+    //5. Source cell holds opponent's piece/tower
+    if ((action%2==CHECKERS_WHITE && source_cell==CHECKERS_BPIECE) ||
+        (action%2==CHECKERS_WHITE && source_cell==CHECKERS_BTOWER) ||
+        (action%2==CHECKERS_BLACK && source_cell==CHECKERS_WPIECE) ||
+        (action%2==CHECKERS_BLACK && source_cell==CHECKERS_WTOWER)) {
+        return CHECKERS_ERROR_5;
+    }
+
+    //6. Other illegal actions
+    // a) Piece does not move diagonally
+    if (abs(s_row-t_row) != abs(s_col-t_col)) {
+        return CHECKERS_ERROR_6;
+    }
+    // b) Piece jumps too far (greater than a distance of 2)
+    if (abs(s_row-t_row)>MAX_DISTANCE || abs(s_col-t_col)>MAX_DISTANCE) {
+        return CHECKERS_ERROR_6;
+    }
+    // c) Piece captures player's own piece, or captures nothing
+    if (abs(s_row-t_row)==MAX_DISTANCE && abs(s_col-t_col)==MAX_DISTANCE) {
+        //this is a capture move
+        cell_captured = board[(s_row+t_row)/2 - 1][(s_col+t_col)/2 - 1];
+        if (cell_captured == CHECKERS_EMPTY ||
+            (action%2 == CHECKERS_WHITE && cell_captured == CHECKERS_WPIECE) ||
+            (action%2 == CHECKERS_WHITE && cell_captured == CHECKERS_WTOWER) ||
+            (action%2 == CHECKERS_BLACK && cell_captured == CHECKERS_BPIECE) ||
+            (action%2 == CHECKERS_BLACK && cell_captured == CHECKERS_BTOWER)) {
+                return CHECKERS_ERROR_6;
+            }
+    }
+    // d) Pieces moving backwards/capturing backwards
+    if (source_cell == CHECKERS_WPIECE) {
+        if (s_row > t_row) {
+            return CHECKERS_ERROR_6;
+        }
+    }
+    if (source_cell == CHECKERS_BPIECE) {
+        if (t_row > s_row) {
+            return CHECKERS_ERROR_6;
+        }
+    }
+
+    // No errors found, must be a legal move
+    return CHECKERS_LEGAL;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns TRUE if both are the same action */
+static int
+same_move(move_t *a, move_t *b) {
+    return a->s_row == b->s_row && a->s_col == b->s_col &&
+           a->t_row == b->t_row && a->t_col == b->t_col;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Takes pieces off the board, one at a time, for as long as the engines
+   still differ on it, so that what is left is a small position that shows
+   a difference.
+*/
+static void
+shrink_position(search_options_t configs[2], game_t *game) {
+    search_result_t results[2];
+    unsigned char removed;
+    int i, j, changed=TRUE;
+
+    while (changed) {
+        changed = FALSE;
+        for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+            for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+                if (game->board[i][j] == CHECKERS_EMPTY) {
+                    continue;
+                }
+                removed = game->board[i][j];
+                game->board[i][j] = CHECKERS_EMPTY;
+                if (compare_position(configs, game, results,
+                                     NULL) != NO_DIFFERENCE) {
+                    changed = TRUE;
+                } else {
+                    game->board[i][j] = removed;
+                }
+            }
+        }
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes what the engines did on a position where they differ, followed by
+   the smallest position that still shows a difference, in the text
+   position format and as a board.
+*/
+static void
+report_difference(FILE *out, char *names[2], char *source, int number,
+                  int kind, search_options_t configs[2], game_t *game,
+                  search_result_t results[2]) {
+    char *kind_names[] = DIFFERENCE_NAMES;
+    search_result_t small_results[2];
+    game_t small;
+    int i;
+
+    fprintf(out, "DIFFERENCE #%d IN %s (%s)\n", number, kind_names[kind],
+            source);
+    write_result(out, names[0], &results[0]);
+    write_result(out, names[1], &results[1]);
+
+    small = *game;
+    shrink_position(configs, &small);
+    kind = compare_position(configs, &small, small_results, NULL);
+    fprintf(out, "  SMALLEST POSITION, DIFFERING IN %s:\n  ",
+            kind_names[kind]);
+    write_text_position(out, &small);
+    fprintf(out, "\n");
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        fprintf(out, "  %d %.*s\n", i+1, CHECKERS_BOARD_SIZE,
+                (char*)small.board[i]);
+    }
+    write_result(out, names[0], &small_results[0]);
+    write_result(out, names[1], &small_results[1]);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes the action an engine chose, its cost and the board cost after it */
+static void
+write_result(FILE *out, char *name, search_result_t *result) {
+    char text[MOVE_TEXT_SIZE];
+
+    if (result->status == CHECKERS_ERROR_MEMORY) {
+        fprintf(out, "  %s: out of memory\n", name);
+        return;
+    }
+    if (result->status == CHECKERS_WIN) {
+        fprintf(out, "  %s: no action\n", name);
+        return;
+    }
+    fprintf(out, "  %s: %s, cost %d, board cost %d\n", name,
+            format_move(&result->move, text), result->score,
+            result->board_cost);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes a position by playing up to RANDOM_ACTIONS random legal actions
+   from the initial board, stopping early if a player has none.
+*/
+static void
+random_position(game_t *game, unsigned long long *state) {
+    move_t moves[CHECKERS_MAX_MOVES];
+    int i, n_actions, n_moves;
+
+    new_game(game);
+    n_actions = next_random(state) % (RANDOM_ACTIONS+1);
+    for (i=0; i<n_actions; i++) {
+        n_moves = list_legal_moves(game, moves);
+        if (n_moves == 0) {
+            break;
+        }
+        play_move(game, &moves[next_random(state) % n_moves]);
+    }
+    return;
+}
+
+/* THE END -------------------------------------------------------------------*/
@@ -0,0 +1,61 @@
+/* Side by side comparison of two search engines.
+
+   Both engines search the same positions: random legal positions, and every
+   position of the given text games. Any difference in the status, chosen
+   action, backed-up cost or board cost is reported, as is any action one of
+   them chooses that is_legal_action() rejects, or any disagreement of
+   list_legal_moves() or is_legal_action() with a frozen copy of the
+   original rules, kept in engine_compare.c. Each difference comes with
+   the smallest position, found by removing pieces, that still shows it.
+   The report ends with the time, boards and memory each engine used.
+*/
+
+#ifndef ENGINE_COMPARE_H
+#define ENGINE_COMPARE_H
+
+#include <stdio.h>
+
+#include "search_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+#define RANDOM_ACTIONS      80      // most random actions in a position
+
+// results of compare_engines()
+#define COMPARE_SAME        0       // the engines agreed on every position
+#define COMPARE_DIFFERENT   1       // at least one difference was found
+#define COMPARE_ERROR_GAME  2       // a game could not be read or replayed
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// Totals of one engine over a comparison
+typedef struct {
+    double     seconds;             //time spent searching
+    long long  nodes;               //boards generated
+    long       memory;              //largest memory of a single search
+} engine_totals_t;
+
+// Totals of a comparison
+typedef struct {
+    int             n_positions;    //positions searched by both engines
+    int             n_differences;  //positions where they differed
+    engine_totals_t totals[2];      //the first and the second engine
+} compare_report_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+int compare_engines(search_options_t configs[2], char *names[2],
+                    int n_random, unsigned long seed,
+                    char *game_paths[], int n_games,
+                    FILE *out, compare_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
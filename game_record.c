@@ -0,0 +1,616 @@
+/* Binary game records with a random-access position index.
+   See game_record.h for the file layout.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "game_record.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+// the text formats
+#define CONVERSION          64      //Conversion from letters (A-Z)to numbers
+#define MOVE_FORMAT         "%c%d-%c%d" // an action, e.g. "G6-F5"
+#define N_CELLS             64      // cells of a text position
+
+#define SQUARE_BITS         0x1f    // bits of an action byte holding square
+#define DIRECTION_SHIFT     5       // position of the direction bits
+#define DIRECTION_BITS      0x03    // direction bits, once shifted down
+#define CAPTURE_BIT         0x80    // set if the action is a capture
+#define CELLS_PER_ROW       4       // dark squares in each row
+#define FIRST_CAPACITY      64      // index entries allocated at first
+#define TEMP_FORMAT         "%s.%ld" // record being written, process id
+#define TEMP_SUFFIX_SIZE    24      // most characters TEMP_FORMAT adds
+
+// codes of the cells in a packed board
+#define CODE_EMPTY          0
+#define CODE_BPIECE         1
+#define CODE_WPIECE         2
+#define CODE_BTOWER         3
+#define CODE_WTOWER         4
+
+
+/* function prototypes ------------------------------------------------------*/
+static void put_uint(unsigned char *bytes, unsigned long long value,
+                     int n_bytes);
+static unsigned long long get_uint(const unsigned char *bytes, int n_bytes);
+static const unsigned char *game_entry(record_reader_t *reader, int game);
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the number (0-31) of a dark square, counting four per row in row
+   major order. Pieces only ever stand on the dark squares, where the row
+   number plus the column number is odd.
+*/
+int
+square_index(int row, int col) {
+    return (row-1)*CELLS_PER_ROW + (col-1)/2;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the one byte form of a legal move or capture */
+int
+encode_move(move_t *move) {
+    int direction, code;
+
+    if (move->t_row < move->s_row) {
+        direction = (move->t_col > move->s_col) ? NE : NW;
+    } else {
+        direction = (move->t_col > move->s_col) ? SE : SW;
+    }
+    code = square_index(move->s_row, move->s_col) |
+           (direction-1) << DIRECTION_SHIFT;
+    if (abs(move->t_row-move->s_row) == MAX_DISTANCE) {
+        code |= CAPTURE_BIT;
+    }
+    return code;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Turns the one byte form of an action back into its source and target */
+void
+decode_move(int code, move_t *move) {
+    int square, direction, distance;
+
+    square = code & SQUARE_BITS;
+    direction = ((code >> DIRECTION_SHIFT) & DIRECTION_BITS) + 1;
+    distance = (code & CAPTURE_BIT) ? MAX_DISTANCE : MOVE_DISTANCE;
+
+    //the dark square of a row is in an even column on odd rows, and the
+    //other way around
+    move->s_row = square/CELLS_PER_ROW + 1;
+    move->s_col = (square%CELLS_PER_ROW)*2 + 1 + move->s_row%2;
+
+    if (direction == NE || direction == NW) {
+        move->t_row = move->s_row - distance;
+    } else {
+        move->t_row = move->s_row + distance;
+    }
+    if (direction == NE || direction == SE) {
+        move->t_col = move->s_col + distance;
+    } else {
+        move->t_col = move->s_col - distance;
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Stores the dark squares of the board in 16 bytes, two cells per byte */
+void
+pack_board(board_t board, unsigned char packed[PACKED_BOARD_SIZE]) {
+    int row, col, code, square;
+
+    memset(packed, 0, PACKED_BOARD_SIZE);
+    for (row=ROW_ONE; row<=ROW_EIGHT; row++) {
+        for (col=COL_ONE+row%2; col<=COL_EIGHT; col+=2) {
+            switch (board[row-1][col-1]) {
+                case CHECKERS_BPIECE: code = CODE_BPIECE; break;
+                case CHECKERS_WPIECE: code = CODE_WPIECE; break;
+                case CHECKERS_BTOWER: code = CODE_BTOWER; break;
+                case CHECKERS_WTOWER: code = CODE_WTOWER; break;
+                default:          code = CODE_EMPTY;  break;
+            }
+            square = square_index(row, col);
+            packed[square/2] |= code << (square%2)*4;
+        }
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Rebuilds a board from its packed form. Returns RECORD_ERROR_FORMAT if a
+   cell holds an unknown code, RECORD_OK otherwise.
+*/
+int
+unpack_board(const unsigned char packed[PACKED_BOARD_SIZE], board_t board) {
+    static const unsigned char cells[] = {CHECKERS_EMPTY, CHECKERS_BPIECE,
+        CHECKERS_WPIECE, CHECKERS_BTOWER, CHECKERS_WTOWER};
+    int row, col, code, square;
+
+    memset(board, CHECKERS_EMPTY, sizeof(board_t));
+    for (row=ROW_ONE; row<=ROW_EIGHT; row++) {
+        for (col=COL_ONE+row%2; col<=COL_EIGHT; col+=2) {
+            square = square_index(row, col);
+            code = (packed[square/2] >> (square%2)*4) & 0x0f;
+            if (code > CODE_WTOWER) {
+                return RECORD_ERROR_FORMAT;
+            }
+            board[row-1][col-1] = cells[code];
+        }
+    }
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Creates the record file under a temporary name, leaving room for the
+   header. 'path' is only written by record_writer_close().
+*/
+int
+record_writer_open(record_writer_t *writer, const char *path) {
+    unsigned char header[RECORD_HEADER_SIZE] = {0};
+
+    writer->n_games = 0;
+    writer->capacity = 0;
+    writer->index = NULL;
+    writer->offset = RECORD_HEADER_SIZE;
+    writer->fp = NULL;
+    writer->path = (char*)malloc(strlen(path) + 1);
+    writer->temp_path = (char*)malloc(strlen(path) + TEMP_SUFFIX_SIZE);
+    if (writer->path == NULL || writer->temp_path == NULL) {
+        record_writer_abort(writer);
+        return RECORD_ERROR_IO;
+    }
+    strcpy(writer->path, path);
+    snprintf(writer->temp_path, strlen(path) + TEMP_SUFFIX_SIZE, TEMP_FORMAT,
+             path, (long)getpid());
+    writer->fp = fopen(writer->temp_path, "wb");
+    if (writer->fp == NULL ||
+        fwrite(header, RECORD_HEADER_SIZE, 1, writer->fp) != 1) {
+        record_writer_abort(writer);
+        return RECORD_ERROR_IO;
+    }
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Replays the game from the initial board, and appends its actions and board
+   checkpoints to the file. Returns RECORD_ERROR_MOVE, and writes nothing, if
+   one of the actions is illegal.
+*/
+int
+record_writer_add_game(record_writer_t *writer, move_t *moves, int n_moves) {
+    game_t game;
+    unsigned char *block, *entry;
+    size_t block_size;
+    int i, n_checkpoints;
+
+    //the game block holds the actions, then a board every RECORD_INTERVAL
+    n_checkpoints = n_moves/RECORD_INTERVAL + 1;
+    block_size = n_moves + (size_t)n_checkpoints*PACKED_BOARD_SIZE;
+    block = (unsigned char*)malloc(block_size);
+    if (block == NULL) {
+        return RECORD_ERROR_IO;
+    }
+
+    new_game(&game);
+    for (i=0; i<=n_moves; i++) {
+        if (i%RECORD_INTERVAL == 0) {
+            pack_board(game.board, block + n_moves +
+                       (i/RECORD_INTERVAL)*PACKED_BOARD_SIZE);
+        }
+        if (i == n_moves) {
+            break;
+        }
+        if (play_move(&game, &moves[i]) != CHECKERS_LEGAL) {
+            free(block);
+            return RECORD_ERROR_MOVE;
+        }
+        block[i] = (unsigned char)encode_move(&moves[i]);
+    }
+
+    //make room in the index before anything is written
+    if (writer->n_games == writer->capacity) {
+        entry = (unsigned char*)realloc(writer->index,
+                    (size_t)(writer->capacity ? 2*writer->capacity
+                             : FIRST_CAPACITY)*RECORD_ENTRY_SIZE);
+        if (entry == NULL) {
+            free(block);
+            return RECORD_ERROR_IO;
+        }
+        writer->index = entry;
+        writer->capacity = writer->capacity ? 2*writer->capacity
+                                            : FIRST_CAPACITY;
+    }
+    if (fwrite(block, block_size, 1, writer->fp) != 1) {
+        free(block);
+        return RECORD_ERROR_IO;
+    }
+    free(block);
+
+    //remember where the game is, for the index
+    entry = writer->index + (size_t)writer->n_games*RECORD_ENTRY_SIZE;
+    put_uint(entry, writer->offset, 8);
+    put_uint(entry+8, n_moves, 4);
+    put_uint(entry+12, 0, 4);
+    writer->n_games++;
+    writer->offset += block_size;
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes the game index and the header, closes the file and renames it to
+   the name given to record_writer_open(). If any of that fails, the file is
+   removed instead.
+*/
+int
+record_writer_close(record_writer_t *writer) {
+    unsigned char header[RECORD_HEADER_SIZE];
+    int status=RECORD_OK;
+
+    memcpy(header, RECORD_MAGIC, 4);
+    put_uint(header+4, RECORD_VERSION, 2);
+    put_uint(header+6, RECORD_INTERVAL, 2);
+    put_uint(header+8, writer->n_games, 4);
+    put_uint(header+12, 0, 4);
+    put_uint(header+16, writer->offset, 8);
+
+    if ((writer->n_games > 0 &&
+         fwrite(writer->index, RECORD_ENTRY_SIZE, writer->n_games,
+                writer->fp) != (size_t)writer->n_games) ||
+        fseek(writer->fp, 0, SEEK_SET) != 0 ||
+        fwrite(header, RECORD_HEADER_SIZE, 1, writer->fp) != 1) {
+        status = RECORD_ERROR_IO;
+    }
+    if (fclose(writer->fp) != 0) {
+        status = RECORD_ERROR_IO;
+    }
+    writer->fp = NULL;
+    if (status == RECORD_OK &&
+        rename(writer->temp_path, writer->path) != 0) {
+        status = RECORD_ERROR_IO;
+    }
+    if (status == RECORD_OK) {
+        //nothing left to remove
+        free(writer->temp_path);
+        writer->temp_path = NULL;
+    }
+    record_writer_abort(writer);
+    return status;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Gives up on a record: closes and removes the file being written, so that
+   nothing of it is left, and frees the writer. Also finishes what
+   record_writer_close() and a failed record_writer_open() leave.
+*/
+void
+record_writer_abort(record_writer_t *writer) {
+    if (writer->fp != NULL) {
+        fclose(writer->fp);
+        writer->fp = NULL;
+    }
+    if (writer->temp_path != NULL) {
+        remove(writer->temp_path);
+    }
+    free(writer->index);
+    free(writer->path);
+    free(writer->temp_path);
+    writer->index = NULL;
+    writer->path = writer->temp_path = NULL;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Maps the record file into memory and checks its header and index. */
+int
+record_open(record_reader_t *reader, const char *path) {
+    struct stat info;
+    unsigned long long index_offset;
+    void *data;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RECORD_ERROR_IO;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return RECORD_ERROR_IO;
+    }
+    if (info.st_size < RECORD_HEADER_SIZE) {
+        close(fd);
+        return RECORD_ERROR_FORMAT;
+    }
+    data = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return RECORD_ERROR_IO;
+    }
+    reader->data = (const unsigned char*)data;
+    reader->size = info.st_size;
+
+    //check the header, and that the whole index is inside the file
+    reader->n_games = get_uint(reader->data+8, 4);
+    reader->interval = get_uint(reader->data+6, 2);
+    index_offset = get_uint(reader->data+16, 8);
+    if (memcmp(reader->data, RECORD_MAGIC, 4) != 0 ||
+        get_uint(reader->data+4, 2) != RECORD_VERSION ||
+        reader->interval == 0 || reader->n_games < 0 ||
+        index_offset > reader->size ||
+        (reader->size - index_offset)/RECORD_ENTRY_SIZE <
+            (unsigned long long)reader->n_games) {
+        record_close(reader);
+        return RECORD_ERROR_FORMAT;
+    }
+    reader->index = reader->data + index_offset;
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Unmaps the record file */
+void
+record_close(record_reader_t *reader) {
+    munmap((void*)reader->data, reader->size);
+    reader->data = reader->index = NULL;
+    reader->size = 0;
+    reader->n_games = 0;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the number of actions in the game (0 for the first game), or -1
+   if there is no such game or its block does not fit in the file.
+*/
+int
+record_game_length(record_reader_t *reader, int game) {
+    const unsigned char *entry;
+    unsigned long long offset, n_moves, size;
+
+    entry = game_entry(reader, game);
+    if (entry == NULL) {
+        return -1;
+    }
+    offset = get_uint(entry, 8);
+    n_moves = get_uint(entry+8, 4);
+    size = n_moves + (n_moves/reader->interval + 1)*PACKED_BOARD_SIZE;
+    if (n_moves > INT_MAX || offset > reader->size ||
+        reader->size - offset < size) {
+        return -1;
+    }
+    return (int)n_moves;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Finds the move of action number 'action' (1 for the first action) of the
+   game.
+*/
+int
+record_get_move(record_reader_t *reader, int game, int action, move_t *move) {
+    int n_moves;
+
+    n_moves = record_game_length(reader, game);
+    if (n_moves < 0 || action < 1 || action > n_moves) {
+        return RECORD_ERROR_RANGE;
+    }
+    decode_move(reader->data[get_uint(game_entry(reader, game), 8) +
+                             action-1], move);
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Sets 'position' to the game after 'action' actions (0 for the initial
+   board), starting from the nearest checkpoint before it.
+*/
+int
+record_position(record_reader_t *reader, int game, int action,
+                game_t *position) {
+    const unsigned char *moves;
+    move_t move;
+    int n_moves, checkpoint;
+
+    n_moves = record_game_length(reader, game);
+    if (n_moves < 0 || action < 0 || action > n_moves) {
+        return RECORD_ERROR_RANGE;
+    }
+    moves = reader->data + get_uint(game_entry(reader, game), 8);
+    checkpoint = action/reader->interval;
+    if (unpack_board(moves + n_moves + checkpoint*PACKED_BOARD_SIZE,
+                     position->board) != RECORD_OK) {
+        return RECORD_ERROR_FORMAT;
+    }
+
+    //replay the few actions since the checkpoint
+    for (position->action=checkpoint*reader->interval;
+         position->action<action; ) {
+        decode_move(moves[position->action], &move);
+        if (play_move(position, &move) != CHECKERS_LEGAL) {
+            return RECORD_ERROR_FORMAT;
+        }
+    }
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reads one action in the text format ("G6-F5"), and the white space after
+   it. The action is not checked. Returns RECORD_ERROR_FORMAT if the next
+   characters are not an action, such as a command letter; the first of
+   them is then left to be read again.
+*/
+int
+read_move(FILE *fp, move_t *move) {
+    char s_col, t_col;          //source column and target column characters
+    int n_read;
+
+    n_read = fscanf(fp, MOVE_FORMAT " ", &s_col, &move->s_row,
+                    &t_col, &move->t_row);
+    if (n_read != 4) {
+        if (n_read >= 1) {
+            ungetc((unsigned char)s_col, fp);
+        }
+        return RECORD_ERROR_FORMAT;
+    }
+    move->s_col = s_col - CONVERSION;  //e.g. column 'A' is converted to 1
+    move->t_col = t_col - CONVERSION;
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes an action in the text format into 'text', and returns 'text' */
+char
+*format_move(move_t *move, char text[MOVE_TEXT_SIZE]) {
+    snprintf(text, MOVE_TEXT_SIZE, MOVE_FORMAT, move->s_col+CONVERSION,
+             move->s_row, move->t_col+CONVERSION, move->t_row);
+    return text;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reads the actions of a text game ("G6-F5" per line) until the end of the
+   file or a line that is not an action, such as a command letter. The
+   actions are not checked. '*moves' is allocated, and must be freed.
+*/
+int
+read_text_game(FILE *fp, move_t **moves, int *n_moves) {
+    move_t move, *grown;
+    int capacity=0;
+
+    *moves = NULL;
+    *n_moves = 0;
+    while (read_move(fp, &move) == RECORD_OK) {
+        if (*n_moves == capacity) {
+            capacity = capacity ? 2*capacity : FIRST_CAPACITY;
+            grown = (move_t*)realloc(*moves, capacity*sizeof(move_t));
+            if (grown == NULL) {
+                free(*moves);
+                *moves = NULL;
+                return RECORD_ERROR_IO;
+            }
+            *moves = grown;
+        }
+        (*moves)[(*n_moves)++] = move;
+    }
+    return ferror(fp) ? RECORD_ERROR_IO : RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes the actions of a game in the text format, one per line */
+void
+write_text_game(FILE *fp, move_t *moves, int n_moves) {
+    char text[MOVE_TEXT_SIZE];
+    int i;
+
+    for (i=0; i<n_moves; i++) {
+        fprintf(fp, "%s\n", format_move(&moves[i], text));
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reads a position written by write_text_position(). Returns
+   RECORD_ERROR_FORMAT if there is none left, or if it holds an unknown cell.
+*/
+int
+read_text_position(FILE *fp, game_t *position) {
+    char cells[N_CELLS+1];
+    int i;
+
+    if (fscanf(fp, " %d %64s", &position->action, cells) != 2 ||
+        strlen(cells) != N_CELLS || position->action < 0) {
+        return RECORD_ERROR_FORMAT;
+    }
+    for (i=0; i<N_CELLS; i++) {
+        if (cells[i] != CHECKERS_EMPTY && cells[i] != CHECKERS_BPIECE &&
+            cells[i] != CHECKERS_WPIECE && cells[i] != CHECKERS_BTOWER &&
+            cells[i] != CHECKERS_WTOWER) {
+            return RECORD_ERROR_FORMAT;
+        }
+        position->board[i/CHECKERS_BOARD_SIZE][i%CHECKERS_BOARD_SIZE] =
+            cells[i];
+    }
+    return RECORD_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes the number of actions made and the 64 cells of the board on one
+   line, without the newline, so that more fields can follow.
+*/
+void
+write_text_position(FILE *fp, game_t *position) {
+    int i, j;
+
+    fprintf(fp, "%d ", position->action);
+    for (i=0; i<CHECKERS_BOARD_SIZE; i++) {
+        for (j=0; j<CHECKERS_BOARD_SIZE; j++) {
+            putc(position->board[i][j], fp);
+        }
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the index entry of the game, or NULL if there is no such game */
+static const unsigned char
+*game_entry(record_reader_t *reader, int game) {
+    if (game < 0 || game >= reader->n_games) {
+        return NULL;
+    }
+    return reader->index + (size_t)game*RECORD_ENTRY_SIZE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Stores the value in 'n_bytes' bytes, least significant byte first */
+static void
+put_uint(unsigned char *bytes, unsigned long long value, int n_bytes) {
+    int i;
+
+    for (i=0; i<n_bytes; i++) {
+        bytes[i] = (unsigned char)(value >> 8*i);
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reads a value stored by put_uint() */
+static unsigned long long
+get_uint(const unsigned char *bytes, int n_bytes) {
+    unsigned long long value=0;
+    int i;
+
+    for (i=n_bytes-1; i>=0; i--) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+/* THE END -------------------------------------------------------------------*/
@@ -0,0 +1,115 @@
+/* Binary game records: many games in one file, one byte per action, with a
+   board checkpoint every RECORD_INTERVAL actions so that the position at any
+   action of any game can be found with at most RECORD_INTERVAL-1 replayed
+   actions.
+
+   File layout (all integers little-endian):
+     header   "CKGR", u16 version, u16 interval, u32 number of games,
+              u32 reserved, u64 offset of the game index
+     games    for each game: its actions (one byte each), followed by the
+              packed boards after 0, interval, 2*interval, ... actions
+     index    for each game: u64 offset of the game, u32 number of actions,
+              u32 reserved
+
+   An action byte holds the source square (bits 0-4, see square_index()),
+   the direction minus one (bits 5-6) and a capture bit (bit 7).
+
+   A record is written under a temporary name and only renamed to its own
+   name by record_writer_close(), so a record that could not be finished
+   never appears, even as a shorter valid one.
+*/
+
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "checkers_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+#define RECORD_MAGIC        "CKGR"  // first bytes of every record file
+#define RECORD_VERSION      1       // version of the layout described above
+#define RECORD_INTERVAL     16      // actions between two board checkpoints
+#define RECORD_HEADER_SIZE  24      // bytes in the file header
+#define RECORD_ENTRY_SIZE   16      // bytes in one game index entry
+#define PACKED_BOARD_SIZE   16      // bytes in a packed board (4 bits a cell)
+#define DARK_SQUARES        32      // cells a piece can ever stand on
+#define MOVE_TEXT_SIZE      32      // chars for an action as text, with '\0'
+
+// results of the record functions
+#define RECORD_OK           0       // no error
+#define RECORD_ERROR_IO     1       // file could not be read or written
+#define RECORD_ERROR_FORMAT 2       // file is not a valid record
+#define RECORD_ERROR_MOVE   3       // a game holds an illegal action
+#define RECORD_ERROR_RANGE  4       // game or action number does not exist
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// Writes a record file one game at a time
+typedef struct {
+    FILE                *fp;        //file being written
+    char                *path;      //name of the finished record
+    char                *temp_path; //name it is written under
+    unsigned long long  offset;     //where the next game will be written
+    unsigned char       *index;     //index entries of the games written
+    int                 n_games;    //number of games written
+    int                 capacity;   //number of entries 'index' can hold
+} record_writer_t;
+
+// Reads a record file through a read-only memory map
+typedef struct {
+    const unsigned char *data;      //the mapped file
+    size_t              size;       //size of the file in bytes
+    const unsigned char *index;     //first game index entry
+    int                 n_games;    //number of games in the file
+    int                 interval;   //actions between two checkpoints
+} record_reader_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+
+// actions and boards in their compact form
+int  square_index(int row, int col);
+int  encode_move(move_t *move);
+void decode_move(int code, move_t *move);
+void pack_board(board_t board, unsigned char packed[PACKED_BOARD_SIZE]);
+int  unpack_board(const unsigned char packed[PACKED_BOARD_SIZE],
+                  board_t board);
+
+// writing
+int  record_writer_open(record_writer_t *writer, const char *path);
+int  record_writer_add_game(record_writer_t *writer, move_t *moves,
+                            int n_moves);
+int  record_writer_close(record_writer_t *writer);
+void record_writer_abort(record_writer_t *writer);
+
+// reading
+int  record_open(record_reader_t *reader, const char *path);
+void record_close(record_reader_t *reader);
+int  record_game_length(record_reader_t *reader, int game);
+int  record_get_move(record_reader_t *reader, int game, int action,
+                     move_t *move);
+int  record_position(record_reader_t *reader, int game, int action,
+                     game_t *position);
+
+// the text formats: "G6-F5" per line for games, and the number of actions
+// made followed by the 64 cells in row major order for positions
+int  read_move(FILE *fp, move_t *move);
+char *format_move(move_t *move, char text[MOVE_TEXT_SIZE]);
+int  read_text_game(FILE *fp, move_t **moves, int *n_moves);
+void write_text_game(FILE *fp, move_t *moves, int n_moves);
+int  read_text_position(FILE *fp, game_t *position);
+void write_text_position(FILE *fp, game_t *position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
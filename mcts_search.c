@@ -0,0 +1,415 @@
+/* Monte Carlo tree search engine.
+   See mcts_search.h for how the threads share the tree.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "mcts_search.h"
+#include "search_util.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+#define EXPLORATION         1.0     //weight of the exploration term of UCT
+#define VIRTUAL_LOSS        1       //visits added while a thread is below
+#define MAX_PATH            256     //deepest a playout goes in the tree
+#define WIN_COST            36      //board cost as good as a win: 12 towers
+#define NOT_EXPANDED        -1      //n_children of a node not expanded yet
+#define SEED_MIXER          0x9E3779B97F4A7C15ULL
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// Node of the search tree, for the board after its action
+typedef struct mcts_node mcts_node_t;
+struct mcts_node {
+    move_t          move;           //action that leads to the node
+    long            visits;         //playouts counted, and virtual losses
+    double          reward;         //sum of the rewards of the playouts,
+                                    //for the player who made the action
+    long long       cost;           //sum of the costs the playouts ended on
+    int             n_children;     //NOT_EXPANDED, or number of actions
+    mcts_node_t     *children;      //one for each action of the board
+    pthread_mutex_t lock;           //guards the children and their counts
+};
+
+// What every thread of a search shares
+typedef struct {
+    mcts_node_t     root;           //the position searched
+    game_t          game;
+    long            playouts;       //playouts to make, 0 for no limit
+    long            started;        //playouts started so far
+    double          deadline;       //time to stop, 0 for no limit
+    int             out_of_memory;  //set by the thread that ran out
+} mcts_tree_t;
+
+// One thread of a search
+typedef struct {
+    mcts_tree_t     *tree;
+    unsigned long long random;      //state of the random numbers
+    long            nodes;          //boards generated
+    long            n_allocated;    //tree nodes made
+} mcts_worker_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+static void *run_worker(void *arg);
+static void run_playout(mcts_worker_t *worker);
+static int  expand_node(mcts_worker_t *worker, mcts_node_t *node,
+                        game_t *game);
+static mcts_node_t *select_child(mcts_node_t *node);
+static double random_playout(mcts_worker_t *worker, game_t *game,
+                             int *final_cost);
+static double cost_reward(int cost);
+static void init_node(mcts_node_t *node);
+static void free_children(mcts_node_t *node);
+
+/* --------------------------------------------------------------------------*/
+
+/* Fills 'config' with the default search: MCTS_PLAYOUTS playouts on
+   MCTS_THREADS threads, with no time limit, from seed 0
+*/
+void
+default_mcts_config(mcts_config_t *config) {
+    config->playouts = MCTS_PLAYOUTS;
+    config->seconds = 0;
+    config->threads = MCTS_THREADS;
+    config->seed = 0;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Chooses the action of the player to move by Monte Carlo tree search. The
+   search makes config->playouts playouts, or searches for config->seconds,
+   whichever ends first, on config->threads threads. The score is the mean
+   board cost the playouts of the chosen action ended on. If memory runs
+   out, every thread stops, the tree is freed and the status is
+   CHECKERS_ERROR_MEMORY.
+*/
+void
+mcts_search(game_t *game, mcts_config_t *config, search_result_t *result) {
+    mcts_worker_t workers[MCTS_MAX_THREADS];
+    pthread_t threads[MCTS_MAX_THREADS];
+    move_t moves[CHECKERS_MAX_MOVES];
+    mcts_node_t *chosen;
+    mcts_tree_t tree;
+    board_t board;
+    long n_allocated=0;
+    int i, n_threads, n_started;
+
+    //a player with no action has lost, and there is nothing to search
+    result->nodes = list_legal_moves(game, moves);
+    result->memory = sizeof(mcts_tree_t);
+    if (result->nodes == 0) {
+        result->status = CHECKERS_WIN;
+        return;
+    }
+
+    init_node(&tree.root);
+    tree.game = *game;
+    tree.playouts = config->playouts;
+    tree.started = 0;
+    tree.out_of_memory = FALSE;
+    tree.deadline = config->seconds > 0 ? now_seconds() + config->seconds : 0;
+    if (tree.playouts <= 0 && tree.deadline == 0) {
+        tree.playouts = MCTS_PLAYOUTS;
+    }
+
+    n_threads = config->threads;
+    if (n_threads < 1) {
+        n_threads = 1;
+    } else if (n_threads > MCTS_MAX_THREADS) {
+        n_threads = MCTS_MAX_THREADS;
+    }
+    for (i=0; i<n_threads; i++) {
+        workers[i].tree = &tree;
+        workers[i].random = (config->seed + i + 1) * SEED_MIXER;
+        workers[i].nodes = 0;
+        workers[i].n_allocated = 0;
+    }
+
+    //this thread is the first worker; a thread that cannot be started
+    //only makes the search slower
+    for (n_started=1; n_started<n_threads; n_started++) {
+        if (pthread_create(&threads[n_started], NULL, run_worker,
+                           &workers[n_started]) != 0) {
+            break;
+        }
+    }
+    run_worker(&workers[0]);
+    for (i=1; i<n_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    result->nodes = 0;
+    for (i=0; i<n_started; i++) {
+        result->nodes += workers[i].nodes;
+        n_allocated += workers[i].n_allocated;
+    }
+    result->memory = sizeof(mcts_tree_t) + n_allocated*sizeof(mcts_node_t) +
+                     n_started*(sizeof(game_t) +
+                                sizeof(move_t[CHECKERS_MAX_MOVES]) +
+                                sizeof(mcts_node_t*[MAX_PATH]));
+
+    if (tree.out_of_memory) {
+        result->status = CHECKERS_ERROR_MEMORY;
+        free_children(&tree.root);
+        pthread_mutex_destroy(&tree.root.lock);
+        return;
+    }
+
+    //the action played out most, the first of them on a tie
+    chosen = &tree.root.children[0];
+    for (i=1; i<tree.root.n_children; i++) {
+        if (tree.root.children[i].visits > chosen->visits) {
+            chosen = &tree.root.children[i];
+        }
+    }
+    copy_board(game->board, board);
+    perform_action(board, &chosen->move);
+    result->status = CHECKERS_NOT_WIN;
+    result->move = chosen->move;
+    result->board_cost = board_cost(board);
+    result->score = chosen->visits > 0
+                    ? (int)lround((double)chosen->cost/chosen->visits)
+                    : result->board_cost;
+
+    free_children(&tree.root);
+    pthread_mutex_destroy(&tree.root.lock);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes playouts until the search has made enough or is out of time. Every
+   thread makes at least one, unless the others already made them all or
+   memory ran out.
+*/
+static void
+*run_worker(void *arg) {
+    mcts_worker_t *worker = arg;
+    mcts_tree_t *tree = worker->tree;
+
+    do {
+        if (__atomic_load_n(&tree->out_of_memory, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (tree->playouts > 0 &&
+            __atomic_fetch_add(&tree->started, 1, __ATOMIC_RELAXED) >=
+            tree->playouts) {
+            break;
+        }
+        run_playout(worker);
+    } while (tree->deadline == 0 || now_seconds() < tree->deadline);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Goes down the tree by the UCT rule to an action no playout has tried
+   yet, plays a random game from there, and counts its result in every node
+   on the way back up. A node that cannot be expanded for lack of memory
+   ends the playout, and the search, uncounted.
+*/
+static void
+run_playout(mcts_worker_t *worker) {
+    mcts_node_t *path[MAX_PATH], *node, *child;
+    game_t game = worker->tree->game;
+    double reward;                  //for black: 1 is a win, 0 a loss
+    int i, depth=0, side, cost, new_leaf;
+
+    node = path[0] = &worker->tree->root;
+    while (TRUE) {
+        pthread_mutex_lock(&node->lock);
+        if (node->n_children == NOT_EXPANDED &&
+            !expand_node(worker, node, &game)) {
+            pthread_mutex_unlock(&node->lock);
+            __atomic_store_n(&worker->tree->out_of_memory, TRUE,
+                             __ATOMIC_RELAXED);
+            return;
+        }
+        if (node->n_children == 0) {
+            //the player to move has lost
+            pthread_mutex_unlock(&node->lock);
+            cost = board_cost(game.board);
+            reward = side_to_move(&game) == CHECKERS_WHITE ? 1.0 : 0.0;
+            break;
+        }
+        child = select_child(node);
+        new_leaf = child->visits == 0;
+        child->visits += VIRTUAL_LOSS;
+        pthread_mutex_unlock(&node->lock);
+
+        perform_action(game.board, &child->move);
+        game.action += 1;
+        path[++depth] = child;
+        if (new_leaf || depth == MAX_PATH-1) {
+            reward = random_playout(worker, &game, &cost);
+            break;
+        }
+        node = child;
+    }
+
+    //the player who made the action of path[i] moved at depth i-1
+    side = side_to_move(&worker->tree->game);
+    for (i=1; i<=depth; i++) {
+        pthread_mutex_lock(&path[i-1]->lock);
+        path[i]->visits += 1 - VIRTUAL_LOSS;
+        path[i]->reward += (side == CHECKERS_BLACK) ? reward : 1.0 - reward;
+        path[i]->cost += cost;
+        pthread_mutex_unlock(&path[i-1]->lock);
+        side = !side;
+    }
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes a child for every action of the board of the node. The node must
+   be locked. Returns FALSE, and leaves the node not expanded, if there is
+   no memory for the children.
+*/
+static int
+expand_node(mcts_worker_t *worker, mcts_node_t *node, game_t *game) {
+    move_t moves[CHECKERS_MAX_MOVES];
+    int i, n_moves;
+
+    n_moves = list_legal_moves(game, moves);
+    worker->nodes += n_moves;
+    node->children = NULL;
+    if (n_moves > 0) {
+        node->children = (mcts_node_t*)malloc(n_moves*sizeof(mcts_node_t));
+        if (node->children == NULL) {
+            return FALSE;
+        }
+    }
+    for (i=0; i<n_moves; i++) {
+        init_node(&node->children[i]);
+        node->children[i].move = moves[i];
+    }
+    worker->n_allocated += n_moves;
+    node->n_children = n_moves;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the first child no playout has tried yet, or else the child with
+   the largest UCT value: its mean reward, plus a term that grows for the
+   children tried less often than their siblings. The node must be locked.
+*/
+static mcts_node_t
+*select_child(mcts_node_t *node) {
+    mcts_node_t *child, *best=NULL;
+    double value, best_value=0, log_visits;
+    long visits=0;
+    int i;
+
+    for (i=0; i<node->n_children; i++) {
+        if (node->children[i].visits == 0) {
+            return &node->children[i];
+        }
+        visits += node->children[i].visits;
+    }
+
+    log_visits = log((double)visits);
+    for (i=0; i<node->n_children; i++) {
+        child = &node->children[i];
+        value = child->reward/child->visits +
+                EXPLORATION*sqrt(log_visits/child->visits);
+        if (best == NULL || value > best_value) {
+            best = child;
+            best_value = value;
+        }
+    }
+    return best;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Plays random actions, captures first, until a player has none left or
+   MCTS_PLAYOUT_ACTIONS were made. Returns the reward for black, and sets
+   'final_cost' to the board cost the playout ended on.
+*/
+static double
+random_playout(mcts_worker_t *worker, game_t *game, int *final_cost) {
+    move_t moves[CHECKERS_MAX_MOVES];
+    int i, n_moves, n_captures, chosen;
+
+    for (i=0; i<MCTS_PLAYOUT_ACTIONS; i++) {
+        n_moves = list_legal_moves(game, moves);
+        worker->nodes += n_moves;
+        if (n_moves == 0) {
+            *final_cost = board_cost(game->board);
+            return side_to_move(game) == CHECKERS_WHITE ? 1.0 : 0.0;
+        }
+
+        //keep the captures at the front of the list
+        n_captures = 0;
+        for (chosen=0; chosen<n_moves; chosen++) {
+            if (abs(moves[chosen].s_row-moves[chosen].t_row) ==
+                MAX_DISTANCE) {
+                moves[n_captures++] = moves[chosen];
+            }
+        }
+        if (n_captures > 0) {
+            n_moves = n_captures;
+        }
+        chosen = next_random(&worker->random) % n_moves;
+        perform_action(game->board, &moves[chosen]);
+        game->action += 1;
+    }
+    *final_cost = board_cost(game->board);
+    return cost_reward(*final_cost);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reward for black of a playout that ended with no winner: from 0 for
+   white being WIN_COST ahead to 1 for black being WIN_COST ahead
+*/
+static double
+cost_reward(int cost) {
+    if (cost > WIN_COST) {
+        cost = WIN_COST;
+    } else if (cost < -WIN_COST) {
+        cost = -WIN_COST;
+    }
+    return 0.5 + cost/(2.0*WIN_COST);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Initialises a node with no playouts and no children yet */
+static void
+init_node(mcts_node_t *node) {
+    node->visits = 0;
+    node->reward = 0;
+    node->cost = 0;
+    node->n_children = NOT_EXPANDED;
+    node->children = NULL;
+    pthread_mutex_init(&node->lock, NULL);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Frees every node below 'node' */
+static void
+free_children(mcts_node_t *node) {
+    int i;
+
+    for (i=0; i<node->n_children; i++) {
+        free_children(&node->children[i]);
+        pthread_mutex_destroy(&node->children[i].lock);
+    }
+    free(node->children);
+    return;
+}
+
+/* THE END -------------------------------------------------------------------*/
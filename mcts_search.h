@@ -0,0 +1,62 @@
+/* Monte Carlo tree search engine.
+
+   Instead of looking at every board a fixed number of actions ahead, the
+   search plays many random games (playouts) from the position, and grows a
+   tree of the actions that lead to the most promising ones, choosing where
+   to go next by the UCT rule. A playout ends when a player has no action
+   left, which is a win or a loss, or after MCTS_PLAYOUT_ACTIONS actions,
+   when the board cost decides how good it was. Captures are preferred in
+   playouts, as a player that misses one usually loses a piece for nothing.
+
+   Several threads grow the same tree. Each node has a lock over its
+   children and their counts, held only while a child is chosen or a
+   playout is counted. A thread on its way down adds a virtual loss to every
+   node it passes, so the other threads try other actions meanwhile, and
+   takes it off again when it counts its playout.
+
+   The search stops after the configured number of playouts or time, and
+   chooses the action of the root that was played out most. With one thread
+   and no time limit it is repeatable for a given seed.
+
+   The engine library does not run this engine, so that it needs no
+   threads: search_driver.c calls mcts_search() for CHECKERS_ENGINE_MCTS.
+*/
+
+#ifndef MCTS_SEARCH_H
+#define MCTS_SEARCH_H
+
+#include "checkers_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+#define MCTS_PLAYOUTS       4000    // default playouts of a search
+#define MCTS_THREADS        1       // default threads of a search
+#define MCTS_MAX_THREADS    256     // most threads of one search
+#define MCTS_PLAYOUT_ACTIONS 100    // most random actions in one playout
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// How long and on how many threads to search
+typedef struct {
+    long       playouts;            //playouts to make, 0 for no limit
+    double     seconds;             //time to search, 0 for no limit
+    int        threads;             //threads growing the same tree
+    unsigned long seed;             //seed of the random playouts
+} mcts_config_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+void default_mcts_config(mcts_config_t *config);
+void mcts_search(game_t *game, mcts_config_t *config,
+                 search_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
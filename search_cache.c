@@ -0,0 +1,296 @@
+/* Search cache kept in a file, shared by every process that opens it.
+   See search_cache.h for how processes share the slots.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "search_cache.h"
+#include "game_record.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+#define CACHE_MAGIC         "CKSC"  // first bytes of every cache file
+#define CACHE_VERSION       2       // version of the slot layout
+#define KEY_SIZE            (PACKED_BOARD_SIZE+2) // board, side and depth
+#define FNV_OFFSET          14695981039346656037ULL
+#define FNV_PRIME           1099511628211ULL
+#define CHECKED_SIZE        (sizeof(cache_slot_t) - \
+                             offsetof(cache_slot_t, key)) // bytes of checksum
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// First bytes of the file
+typedef struct {
+    char            magic[4];       //CACHE_MAGIC
+    unsigned int    version;        //CACHE_VERSION
+    unsigned int    slot_size;      //sizeof(cache_slot_t)
+    unsigned int    reserved;
+    unsigned long long n_slots;     //number of slots after the header
+} cache_header_t;
+
+// One cached search result
+typedef struct {
+    unsigned long long check;       //hash of the rest of the slot
+    unsigned char   key[KEY_SIZE];  //all zero while the slot is unused
+    unsigned char   status;         //CHECKERS_WIN or CHECKERS_NOT_WIN
+    unsigned char   s_row, s_col;   //the chosen action
+    unsigned char   t_row, t_col;
+    int             score;          //backed-up cost of the action
+    int             board_cost;     //board cost after the action
+} cache_slot_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+static int  make_key(game_t *game, int depth, unsigned char key[KEY_SIZE]);
+static unsigned long long hash_bytes(const unsigned char *bytes,
+                                     size_t size);
+static unsigned long long slot_check(cache_slot_t *slot);
+static cache_slot_t *first_way(search_cache_t *cache,
+                               unsigned char key[KEY_SIZE]);
+
+/* --------------------------------------------------------------------------*/
+
+/* Opens the cache file, creating it with 'n_slots' slots (CACHE_SLOTS if 0)
+   if it does not exist yet. An existing file keeps its own size. The file
+   is locked while its header is checked or written, so processes starting
+   together agree on it.
+*/
+int
+cache_open(search_cache_t *cache, const char *path, unsigned long n_slots) {
+    cache_header_t header;
+    struct stat info;
+    size_t size;
+    void *data;
+    int fd, status=CACHE_OK;
+
+    if (n_slots == 0) {
+        n_slots = CACHE_SLOTS;
+    }
+    n_slots += (CACHE_WAYS - n_slots%CACHE_WAYS) % CACHE_WAYS;
+
+    fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (fd < 0) {
+        return CACHE_ERROR_IO;
+    }
+    if (flock(fd, LOCK_EX) != 0 || fstat(fd, &info) != 0) {
+        close(fd);
+        return CACHE_ERROR_IO;
+    }
+
+    if (info.st_size == 0) {
+        //a new file: zero filled slots are unused
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CACHE_MAGIC, 4);
+        header.version = CACHE_VERSION;
+        header.slot_size = sizeof(cache_slot_t);
+        header.n_slots = n_slots;
+        size = sizeof(header) + n_slots*sizeof(cache_slot_t);
+        if (ftruncate(fd, size) != 0 ||
+            pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+            status = CACHE_ERROR_IO;
+        }
+    } else if (pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+        status = CACHE_ERROR_FORMAT;
+    } else {
+        size = info.st_size;
+        if (memcmp(header.magic, CACHE_MAGIC, 4) != 0 ||
+            header.version != CACHE_VERSION ||
+            header.slot_size != sizeof(cache_slot_t) ||
+            header.n_slots == 0 || header.n_slots%CACHE_WAYS != 0 ||
+            (size - sizeof(header))/sizeof(cache_slot_t) != header.n_slots) {
+            status = CACHE_ERROR_FORMAT;
+        }
+    }
+    flock(fd, LOCK_UN);
+    if (status != CACHE_OK) {
+        close(fd);
+        return status;
+    }
+
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return CACHE_ERROR_IO;
+    }
+    cache->data = data;
+    cache->size = size;
+    cache->slots = (char*)data + sizeof(header);
+    cache->n_slots = header.n_slots;
+    return CACHE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Unmaps the cache file. What was stored stays in the file. */
+void
+cache_close(search_cache_t *cache) {
+    munmap(cache->data, cache->size);
+    cache->data = cache->slots = NULL;
+    cache->size = 0;
+    cache->n_slots = 0;
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Looks for the result of a search of the game to the given depth. Returns
+   CACHE_HIT and fills 'result' (with 0 nodes and memory) if it is in the cache.
+*/
+int
+cache_lookup(search_cache_t *cache, game_t *game, int depth,
+             search_result_t *result) {
+    unsigned char key[KEY_SIZE];
+    cache_slot_t *slot, copy;
+    int way;
+
+    if (!make_key(game, depth, key)) {
+        return CACHE_MISS;
+    }
+    slot = first_way(cache, key);
+    for (way=0; way<CACHE_WAYS; way++, slot++) {
+        //copy the slot, and keep the copy only if it was written whole
+        memcpy(&copy, slot, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (memcmp(copy.key, key, KEY_SIZE) != 0 ||
+            copy.check != slot_check(&copy)) {
+            continue;
+        }
+
+        result->status = copy.status;
+        result->move.s_row = copy.s_row;
+        result->move.s_col = copy.s_col;
+        result->move.t_row = copy.t_row;
+        result->move.t_col = copy.t_col;
+        result->score = copy.score;
+        result->board_cost = copy.board_cost;
+        result->nodes = 0;
+        result->memory = 0;
+        return CACHE_HIT;
+    }
+    return CACHE_MISS;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Stores the result of a search of the game to the given depth. It goes in
+   the way that already holds the position, or else an unused way, or else
+   replaces one picked by the hash. The slot is made whole in a copy, with
+   its checksum, and then written in one go; if another process writes the
+   same slot at the same time, the mix of both fails the checksum and is
+   read as a miss until the next store.
+*/
+void
+cache_store(search_cache_t *cache, game_t *game, int depth,
+            search_result_t *result) {
+    unsigned char key[KEY_SIZE], empty[KEY_SIZE] = {0};
+    cache_slot_t *slot, *chosen=NULL, copy;
+    int way;
+
+    if (!make_key(game, depth, key)) {
+        return;
+    }
+    slot = first_way(cache, key);
+    for (way=0; way<CACHE_WAYS && chosen==NULL; way++) {
+        if (memcmp(slot[way].key, key, KEY_SIZE) == 0) {
+            chosen = &slot[way];
+        }
+    }
+    for (way=0; way<CACHE_WAYS && chosen==NULL; way++) {
+        if (memcmp(slot[way].key, empty, KEY_SIZE) == 0) {
+            chosen = &slot[way];
+        }
+    }
+    if (chosen == NULL) {
+        chosen = &slot[(hash_bytes(key, KEY_SIZE) >> 32) % CACHE_WAYS];
+    }
+
+    //padding included, so that the checksum covers known bytes only
+    memset(&copy, 0, sizeof(copy));
+    memcpy(copy.key, key, KEY_SIZE);
+    copy.status = result->status;
+    copy.s_row = result->move.s_row;
+    copy.s_col = result->move.s_col;
+    copy.t_row = result->move.t_row;
+    copy.t_col = result->move.t_col;
+    copy.score = result->score;
+    copy.board_cost = result->board_cost;
+    copy.check = slot_check(&copy);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(chosen, &copy, sizeof(copy));
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes the key of a search: the packed board, the player to move and the
+   depth. Returns FALSE for a search that is never cached: a board the
+   packed form cannot hold (a piece on a light square, or an unknown cell),
+   or a depth too large for its byte.
+*/
+static int
+make_key(game_t *game, int depth, unsigned char key[KEY_SIZE]) {
+    board_t unpacked;
+
+    if (depth > UCHAR_MAX) {
+        return FALSE;
+    }
+    pack_board(game->board, key);
+    if (unpack_board(key, unpacked) != RECORD_OK ||
+        memcmp(unpacked, game->board, sizeof(board_t)) != 0) {
+        return FALSE;
+    }
+    //the side is stored as 1 or 2, so that no used key is all zero
+    key[PACKED_BOARD_SIZE] = side_to_move(game) + 1;
+    key[PACKED_BOARD_SIZE+1] = depth;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* 64 bit FNV-1a hash of some bytes */
+static unsigned long long
+hash_bytes(const unsigned char *bytes, size_t size) {
+    unsigned long long hash=FNV_OFFSET;
+    size_t i;
+
+    for (i=0; i<size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Checksum of a slot: the hash of everything after 'check'. An unused slot,
+   all zero, does not match it either.
+*/
+static unsigned long long
+slot_check(cache_slot_t *slot) {
+    return hash_bytes((unsigned char*)slot + offsetof(cache_slot_t, key),
+                      CHECKED_SIZE);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns the first of the CACHE_WAYS slots the key may be stored in */
+static cache_slot_t
+*first_way(search_cache_t *cache, unsigned char key[KEY_SIZE]) {
+    unsigned long n_sets = cache->n_slots/CACHE_WAYS;
+    return (cache_slot_t*)cache->slots +
+           (hash_bytes(key, KEY_SIZE) % n_sets)*CACHE_WAYS;
+}
+
+/* THE END -------------------------------------------------------------------*/
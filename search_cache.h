@@ -0,0 +1,69 @@
+/* Search cache kept in a file, shared by every process that opens it.
+
+   The file is a fixed-size hash table of search results, keyed by the
+   board, the player to move and the search depth, and mapped into memory.
+   A lookup is a few memory reads, so a position that has been searched
+   before, by this process or any other, costs a page-cache lookup instead
+   of a search.
+
+   Processes read and write the table at the same time without locks: each
+   slot carries a checksum of its key and result, and a reader that finds
+   the checksum wrong, because the slot was being written or a writer died
+   half-way, treats the slot as a miss. Nothing is ever held, so the next
+   store simply writes the slot again, and the worst a race or a crash can
+   do is cost a search. The file holds the slots as laid out in memory, so
+   it is specific to the machine architecture.
+*/
+
+#ifndef SEARCH_CACHE_H
+#define SEARCH_CACHE_H
+
+#include <stddef.h>
+
+#include "checkers_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+#define CACHE_SLOTS         262144  // slots in a new cache file
+#define CACHE_WAYS          4       // slots a position may be stored in
+
+// results of cache_open()
+#define CACHE_OK            0       // no error
+#define CACHE_ERROR_IO      1       // file could not be created or mapped
+#define CACHE_ERROR_FORMAT  2       // file is not a cache of this layout
+
+// results of cache_lookup()
+#define CACHE_HIT           1       // the search was in the cache
+#define CACHE_MISS          0       // it was not
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// An open cache file
+typedef struct search_cache search_cache_t;
+struct search_cache {
+    void            *data;          //the mapped file
+    size_t          size;           //size of the file in bytes
+    void            *slots;         //first slot
+    unsigned long   n_slots;        //number of slots, a multiple of the ways
+};
+
+
+/* function prototypes ------------------------------------------------------*/
+int  cache_open(search_cache_t *cache, const char *path,
+                unsigned long n_slots);
+void cache_close(search_cache_t *cache);
+int  cache_lookup(search_cache_t *cache, game_t *game, int depth,
+                  search_result_t *result);
+void cache_store(search_cache_t *cache, game_t *game, int depth,
+                 search_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
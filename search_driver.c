@@ -0,0 +1,56 @@
+/* Searches as the front ends run them.
+   See search_driver.h for what is done here rather than in the engine.
+*/
+
+#include "search_driver.h"
+
+/* --------------------------------------------------------------------------*/
+
+/* Fills 'options' with the default search of the engine, without a cache,
+   and the default Monte Carlo search
+*/
+void
+default_search_options(search_options_t *options) {
+    search_config_t config;
+
+    default_search_config(&config);
+    options->engine = config.engine;
+    options->depth = config.depth;
+    options->cache = NULL;
+    default_mcts_config(&options->mcts);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Searches the game with the engine of the options: mcts_search() for the
+   Monte Carlo engine, search_move() for the others. If the options have a
+   cache, a minimax search is looked up in it first, and its result stored
+   in it after, unless the search failed. The Monte Carlo engine never uses
+   the cache, as its result does not depend on the depth alone.
+*/
+int
+run_search(game_t *game, search_options_t *options,
+           search_result_t *result) {
+    search_config_t config;
+
+    if (options->engine == CHECKERS_ENGINE_MCTS) {
+        mcts_search(game, &options->mcts, result);
+        return result->status;
+    }
+
+    config.engine = options->engine;
+    config.depth = options->depth < 1 ? 1 : options->depth;
+    if (options->cache != NULL &&
+        cache_lookup(options->cache, game, config.depth, result) == CACHE_HIT) {
+        return result->status;
+    }
+    search_move(game, &config, result);
+    if (options->cache != NULL && (result->status == CHECKERS_WIN ||
+                                   result->status == CHECKERS_NOT_WIN)) {
+        cache_store(options->cache, game, config.depth, result);
+    }
+    return result->status;
+}
+
+/* THE END -------------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/* Searches as the front ends run them: the engine of the options, with the
+   search cache around it.
+
+   The engine library (checkers_engine.c) only runs the minimax engines.
+   Running the Monte Carlo engine, and looking a search up in a cache file
+   before running it and storing its result after, are done here, so that a
+   program embedding the engine needs neither threads, nor the cache and its
+   file handling.
+*/
+
+#ifndef SEARCH_DRIVER_H
+#define SEARCH_DRIVER_H
+
+#include "checkers_engine.h"
+#include "search_cache.h"
+#include "mcts_search.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* type definitions ------------------------------ -------------------------*/
+
+// How the front ends search
+typedef struct {
+    int        engine;              //one of the CHECKERS_ENGINE_* engines
+    int        depth;               //minimax: actions looked ahead
+    search_cache_t *cache;          //minimax: looked up first, or NULL
+    mcts_config_t  mcts;            //Monte Carlo: playouts, time, threads
+} search_options_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+void default_search_options(search_options_t *options);
+int  run_search(game_t *game, search_options_t *options,
+                search_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
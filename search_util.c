@@ -0,0 +1,34 @@
+/* Small helpers shared by the searches and the tools that time them. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#include "search_util.h"
+
+/* --------------------------------------------------------------------------*/
+
+/* xorshift64* random numbers: the next number of the sequence kept in
+   'state', which must not be 0. A seed always gives the same sequence on
+   every machine, and each caller (or thread) keeps its own state.
+*/
+unsigned long long
+next_random(unsigned long long *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (*state * 2685821657736338717ULL) >> 32;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Seconds on a clock that only goes forward */
+double
+now_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+/* THE END -------------------------------------------------------------------*/
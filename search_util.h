@@ -0,0 +1,20 @@
+/* Small helpers shared by the searches and the tools that time them:
+   repeatable random numbers, and a clock for measuring time.
+*/
+
+#ifndef SEARCH_UTIL_H
+#define SEARCH_UTIL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* function prototypes ------------------------------------------------------*/
+unsigned long long next_random(unsigned long long *state);
+double now_seconds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
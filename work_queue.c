@@ -0,0 +1,765 @@
+/* Sharded analysis through a work queue kept in a directory.
+   See work_queue.h for the layout of the directory.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "work_queue.h"
+#include "game_record.h"
+#include "checkers_rules.h"
+
+/* Definitions ------------------------------------------------------*/
+
+#define STAGING_DIR         "staging"
+#define PENDING_DIR         "pending"
+#define CLAIMED_DIR         "claimed"
+#define RESULTS_DIR         "results"
+#define SUB_DIRS            {STAGING_DIR, PENDING_DIR, CLAIMED_DIR, \
+                             RESULTS_DIR}
+#define N_SUB_DIRS          4
+#define MANIFEST_FILE       "manifest"
+#define MANIFEST_FORMAT     "shards %d depth %d engine %d playouts %ld " \
+                            "seed %lu\n"
+#define SHARD_FORMAT        "%s/%s/%06d"    // dir, sub directory, shard
+#define TEMP_FORMAT         "%s/%s/.%06d.%s.%ld" // ... host, process id
+#define HOST_SIZE           64      // longest host name kept
+#define POLL_SECONDS        1       // wait between two looks at the queue
+#define COPY_SIZE           65536   // bytes copied at a time when merging
+#define NO_SHARD            -1
+#define RENEWALS            3       // lease renewals within one lease time
+
+
+/* type definitions ------------------------------ -------------------------*/
+
+// Shard being written by queue_create()
+typedef struct {
+    const char  *dir;               //queue directory
+    int         shard_size;         //positions in a full shard
+    int         n_shards;           //shards started so far
+    int         n_positions;        //positions in the current shard
+    FILE        *fp;                //current shard, or NULL
+    char        temp_path[PATH_MAX];//where the current shard is written
+} shard_writer_t;
+
+// Thread renewing the lease of a claimed shard while it is searched
+typedef struct {
+    const char  *claimed_path;      //the claimed shard
+    int         interval;           //seconds between two renewals
+    int         stop;               //set when the shard is done
+    pthread_mutex_t lock;           //guards 'stop'
+    pthread_cond_t  done;           //signalled when 'stop' is set
+    pthread_t   thread;
+} lease_keeper_t;
+
+
+/* function prototypes ------------------------------------------------------*/
+static int  add_position(shard_writer_t *writer, game_t *position);
+static int  finish_shard(shard_writer_t *writer);
+static int  publish_shards(const char *dir, int n_shards);
+static int  write_manifest(const char *dir, search_options_t *config,
+                           int n_shards);
+static void discard_queue(const char *dir, int n_shards);
+static int  is_being_created(const char *dir, int lease_seconds);
+static int  read_manifest(const char *dir, int *n_shards,
+                          search_options_t *config);
+static int  is_repeatable(search_options_t *config);
+static void reclaim_expired(const char *dir, int lease_seconds);
+static int  claim_shard(const char *dir);
+static int  count_shards(const char *dir, const char *sub_dir);
+static int  search_shard(const char *dir, int shard, int lease_seconds,
+                         search_options_t *config, int *n_searched);
+static int  start_lease(lease_keeper_t *keeper, const char *claimed_path,
+                        int lease_seconds);
+static void stop_lease(lease_keeper_t *keeper);
+static void *keep_lease(void *arg);
+static int  file_exists(const char *path);
+static void temp_name(char *path, const char *dir, const char *sub_dir,
+                      int shard);
+
+/* --------------------------------------------------------------------------*/
+
+/* Creates the queue directory, and splits the corpus into shards of
+   'shard_size' positions. The corpus is either a binary game record, in
+   which case every position of every game is queued, or a text file of
+   positions. Every position will be searched with the engine, depth and
+   Monte Carlo playouts and seed of 'config', which go in the manifest.
+   Returns QUEUE_ERROR_OPTIONS if the searches would not be repeatable: a
+   Monte Carlo search with a time limit or more than one thread.
+
+   The shards are written in staging/, and only moved into pending/ once
+   the whole corpus has been read; the manifest is written last, so workers
+   started early wait for the whole corpus to be queued. A directory that
+   already holds a queue, finished or not, is refused. If the corpus is
+   invalid, or anything else fails, everything written is removed again.
+*/
+int
+queue_create(const char *dir, const char *corpus_path, int shard_size,
+             search_options_t *config, int *n_shards) {
+    const char *sub_dirs[N_SUB_DIRS] = SUB_DIRS;
+    char path[PATH_MAX], cell;
+    shard_writer_t writer;
+    record_reader_t reader;
+    game_t position;
+    FILE *fp;
+    int i, game, action, n_moves, status=QUEUE_OK;
+
+    if (!is_repeatable(config)) {
+        return QUEUE_ERROR_OPTIONS;
+    }
+
+    //make the directories. A queue already there is never touched
+    snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_FILE);
+    if ((mkdir(dir, 0777) != 0 && errno != EEXIST) || file_exists(path)) {
+        return QUEUE_ERROR_IO;
+    }
+    for (i=0; i<N_SUB_DIRS; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, sub_dirs[i]);
+        if ((mkdir(path, 0777) != 0 && errno != EEXIST) ||
+            count_shards(dir, sub_dirs[i]) > 0) {
+            return QUEUE_ERROR_IO;
+        }
+    }
+
+    writer.dir = dir;
+    writer.shard_size = shard_size > 0 ? shard_size : 1;
+    writer.n_shards = 0;
+    writer.n_positions = 0;
+    writer.fp = NULL;
+
+    if (record_open(&reader, corpus_path) == RECORD_OK) {
+        //a game record: queue every position of every game
+        for (game=0; game<reader.n_games && status==QUEUE_OK; game++) {
+            n_moves = record_game_length(&reader, game);
+            if (n_moves < 0) {
+                status = QUEUE_ERROR_CORPUS;
+            }
+            for (action=0; action<=n_moves && status==QUEUE_OK; action++) {
+                if (record_position(&reader, game, action,
+                                    &position) != RECORD_OK) {
+                    status = QUEUE_ERROR_CORPUS;
+                } else {
+                    status = add_position(&writer, &position);
+                }
+            }
+        }
+        record_close(&reader);
+    } else {
+        //a text file of positions
+        fp = fopen(corpus_path, "r");
+        if (fp == NULL) {
+            discard_queue(dir, 0);
+            return QUEUE_ERROR_IO;
+        }
+        while (status==QUEUE_OK &&
+               read_text_position(fp, &position) == RECORD_OK) {
+            status = add_position(&writer, &position);
+        }
+        //anything but white space left means a position could not be read
+        if (status == QUEUE_OK && fscanf(fp, " %c", &cell) == 1) {
+            status = QUEUE_ERROR_CORPUS;
+        }
+        fclose(fp);
+    }
+    if (status == QUEUE_OK) {
+        status = finish_shard(&writer);
+    } else if (writer.fp != NULL) {
+        fclose(writer.fp);
+        remove(writer.temp_path);
+    }
+
+    //every shard is written. Queue them, then let the workers start
+    if (status == QUEUE_OK) {
+        status = publish_shards(dir, writer.n_shards);
+    }
+    if (status == QUEUE_OK) {
+        status = write_manifest(dir, config, writer.n_shards);
+    }
+    if (status != QUEUE_OK) {
+        discard_queue(dir, writer.n_shards);
+        return status;
+    }
+    snprintf(path, sizeof(path), "%s/%s", dir, STAGING_DIR);
+    rmdir(path);
+    *n_shards = writer.n_shards;
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Works on the queue until every shard has been searched. A worker started
+   before queue_create() has written the manifest waits for it, as long as
+   the queue is still being created: the directory exists, and it or its
+   staging/ changed within the lease time. Then it claims a pending shard,
+   searches it and writes its results, and puts back the shards whose lease
+   has expired. While other workers still hold shards, waits in case their
+   lease runs out. The positions are searched with the settings of the
+   manifest, so that every worker agrees; only the cache of 'config' is
+   used, and QUEUE_ERROR_OPTIONS is returned if it asks for a time limit or
+   more than one thread while the manifest names the Monte Carlo engine, as
+   the results would then not be repeatable. 'n_searched' counts the
+   positions searched. A search that runs out of memory stops the worker
+   with QUEUE_ERROR_MEMORY, and its shard is left to the next worker once
+   the lease expires.
+*/
+int
+queue_work(const char *dir, int lease_seconds, search_options_t *config,
+           int *n_searched) {
+    search_options_t queue_config;
+    char path[PATH_MAX];
+    int n_shards, shard, status;
+
+    *n_searched = 0;
+    snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_FILE);
+    while (!file_exists(path)) {
+        if (!is_being_created(dir, lease_seconds)) {
+            return QUEUE_ERROR_IO;
+        }
+        sleep(POLL_SECONDS);
+    }
+    queue_config = *config;
+    if (read_manifest(dir, &n_shards, &queue_config) != QUEUE_OK) {
+        return QUEUE_ERROR_IO;
+    }
+    if (!is_repeatable(&queue_config)) {
+        return QUEUE_ERROR_OPTIONS;
+    }
+    while (count_shards(dir, RESULTS_DIR) < n_shards) {
+        reclaim_expired(dir, lease_seconds);
+        shard = claim_shard(dir);
+        if (shard != NO_SHARD) {
+            status = search_shard(dir, shard, lease_seconds, &queue_config,
+                                  n_searched);
+            if (status != QUEUE_OK) {
+                return status;
+            }
+        } else if (count_shards(dir, CLAIMED_DIR) == 0 &&
+                   count_shards(dir, PENDING_DIR) == 0) {
+            //nothing left that could ever be searched
+            break;
+        } else {
+            sleep(POLL_SECONDS);
+        }
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Joins the results of every shard, in shard order, into one file. Returns
+   QUEUE_NOT_FINISHED, and writes nothing, if some shards have no results
+   yet; 'n_missing' is set to how many.
+*/
+int
+queue_merge(const char *dir, const char *out_path, int *n_missing) {
+    char path[PATH_MAX], temp_path[PATH_MAX], *buffer;
+    FILE *in, *out;
+    size_t n_bytes;
+    search_options_t config;
+    int n_shards, shard, status=QUEUE_OK;
+
+    *n_missing = 0;
+    if (read_manifest(dir, &n_shards, &config) != QUEUE_OK) {
+        return QUEUE_ERROR_IO;
+    }
+    for (shard=0; shard<n_shards; shard++) {
+        snprintf(path, sizeof(path), SHARD_FORMAT, dir, RESULTS_DIR, shard);
+        if (!file_exists(path)) {
+            *n_missing += 1;
+        }
+    }
+    if (*n_missing > 0) {
+        return QUEUE_NOT_FINISHED;
+    }
+
+    buffer = (char*)malloc(COPY_SIZE);
+    snprintf(temp_path, sizeof(temp_path), "%s.%ld", out_path,
+             (long)getpid());
+    out = fopen(temp_path, "w");
+    if (buffer == NULL || out == NULL) {
+        free(buffer);
+        if (out != NULL) {
+            fclose(out);
+        }
+        return QUEUE_ERROR_IO;
+    }
+    for (shard=0; shard<n_shards && status==QUEUE_OK; shard++) {
+        snprintf(path, sizeof(path), SHARD_FORMAT, dir, RESULTS_DIR, shard);
+        in = fopen(path, "r");
+        if (in == NULL) {
+            status = QUEUE_ERROR_IO;
+            break;
+        }
+        while ((n_bytes = fread(buffer, 1, COPY_SIZE, in)) > 0) {
+            if (fwrite(buffer, 1, n_bytes, out) != n_bytes) {
+                status = QUEUE_ERROR_IO;
+                break;
+            }
+        }
+        if (ferror(in)) {
+            status = QUEUE_ERROR_IO;
+        }
+        fclose(in);
+    }
+    free(buffer);
+    if (fclose(out) != 0 || status != QUEUE_OK ||
+        rename(temp_path, out_path) != 0) {
+        remove(temp_path);
+        return QUEUE_ERROR_IO;
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Adds a position to the current shard, starting a new shard if needed */
+static int
+add_position(shard_writer_t *writer, game_t *position) {
+    if (writer->fp == NULL) {
+        temp_name(writer->temp_path, writer->dir, STAGING_DIR,
+                  writer->n_shards);
+        writer->fp = fopen(writer->temp_path, "w");
+        if (writer->fp == NULL) {
+            return QUEUE_ERROR_IO;
+        }
+        writer->n_shards++;
+        writer->n_positions = 0;
+    }
+    write_text_position(writer->fp, position);
+    putc('\n', writer->fp);
+    writer->n_positions++;
+    if (writer->n_positions == writer->shard_size) {
+        return finish_shard(writer);
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Closes the current shard, if any, and moves it into staging/ under its
+   final name
+*/
+static int
+finish_shard(shard_writer_t *writer) {
+    char path[PATH_MAX];
+    int status;
+
+    if (writer->fp == NULL) {
+        return QUEUE_OK;
+    }
+    snprintf(path, sizeof(path), SHARD_FORMAT, writer->dir, STAGING_DIR,
+             writer->n_shards-1);
+    status = fclose(writer->fp);
+    writer->fp = NULL;
+    if (status != 0 || rename(writer->temp_path, path) != 0) {
+        remove(writer->temp_path);
+        return QUEUE_ERROR_IO;
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Moves every shard from staging/ into pending/, where workers claim them */
+static int
+publish_shards(const char *dir, int n_shards) {
+    char staged_path[PATH_MAX], pending_path[PATH_MAX];
+    int shard;
+
+    for (shard=0; shard<n_shards; shard++) {
+        snprintf(staged_path, sizeof(staged_path), SHARD_FORMAT, dir,
+                 STAGING_DIR, shard);
+        snprintf(pending_path, sizeof(pending_path), SHARD_FORMAT, dir,
+                 PENDING_DIR, shard);
+        if (rename(staged_path, pending_path) != 0) {
+            return QUEUE_ERROR_IO;
+        }
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Writes the manifest, which appears under its name in one step */
+static int
+write_manifest(const char *dir, search_options_t *config, int n_shards) {
+    char path[PATH_MAX], temp_path[PATH_MAX];
+    FILE *fp;
+
+    temp_name(temp_path, dir, "", 0);
+    snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_FILE);
+    fp = fopen(temp_path, "w");
+    if (fp == NULL) {
+        return QUEUE_ERROR_IO;
+    }
+    fprintf(fp, MANIFEST_FORMAT, n_shards, config->depth, config->engine,
+            config->mcts.playouts, config->mcts.seed);
+    if (fclose(fp) != 0 || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return QUEUE_ERROR_IO;
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Removes what queue_create() wrote: the first 'n_shards' shards, wherever
+   they got to, and the directories, which are empty once they are gone.
+   Workers waiting for the manifest then see that the queue is not coming.
+*/
+static void
+discard_queue(const char *dir, int n_shards) {
+    const char *sub_dirs[N_SUB_DIRS] = SUB_DIRS;
+    char path[PATH_MAX];
+    int i, shard;
+
+    for (shard=0; shard<n_shards; shard++) {
+        snprintf(path, sizeof(path), SHARD_FORMAT, dir, STAGING_DIR, shard);
+        remove(path);
+        snprintf(path, sizeof(path), SHARD_FORMAT, dir, PENDING_DIR, shard);
+        remove(path);
+    }
+    for (i=0; i<N_SUB_DIRS; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, sub_dirs[i]);
+        rmdir(path);
+    }
+    rmdir(dir);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns TRUE if a queue with no manifest yet may still get one: the
+   directory exists, and it or its staging/ changed within the lease time.
+   A coordinator that died part-way stops changing them.
+*/
+static int
+is_being_created(const char *dir, int lease_seconds) {
+    char path[PATH_MAX];
+    struct stat info;
+    time_t changed;
+
+    if (stat(dir, &info) != 0) {
+        return FALSE;
+    }
+    changed = info.st_mtime;
+    snprintf(path, sizeof(path), "%s/%s", dir, STAGING_DIR);
+    if (stat(path, &info) == 0 && info.st_mtime > changed) {
+        changed = info.st_mtime;
+    }
+    return time(NULL) - changed <= lease_seconds;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Reads the number of shards and the search settings from the manifest
+   into 'config', whose cache, threads and time limit are left as they are
+*/
+static int
+read_manifest(const char *dir, int *n_shards, search_options_t *config) {
+    char path[PATH_MAX];
+    FILE *fp;
+    int status=QUEUE_OK;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_FILE);
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return QUEUE_ERROR_IO;
+    }
+    if (fscanf(fp, MANIFEST_FORMAT, n_shards, &config->depth,
+               &config->engine, &config->mcts.playouts,
+               &config->mcts.seed) != 5) {
+        status = QUEUE_ERROR_IO;
+    }
+    fclose(fp);
+    return status;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns TRUE if searches with 'config' always give the same result. The
+   minimax engines always do. The Monte Carlo engine needs one thread and no
+   time limit, as it otherwise depends on how the threads and the clock ran.
+*/
+static int
+is_repeatable(search_options_t *config) {
+    return config->engine != CHECKERS_ENGINE_MCTS ||
+           (config->mcts.threads <= 1 && config->mcts.seconds <= 0);
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Puts every claimed shard whose lease is older than 'lease_seconds' back
+   in pending/. When several workers do this at the same time, only one
+   rename succeeds. Leases are compared with this machine's clock, so the
+   machines sharing a queue should keep their clocks in step.
+*/
+static void
+reclaim_expired(const char *dir, int lease_seconds) {
+    char path[PATH_MAX], claimed_path[PATH_MAX], pending_path[PATH_MAX];
+    struct dirent *entry;
+    struct stat info;
+    DIR *claimed;
+    time_t now;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, CLAIMED_DIR);
+    claimed = opendir(path);
+    if (claimed == NULL) {
+        return;
+    }
+    now = time(NULL);
+    while ((entry = readdir(claimed)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(claimed_path, sizeof(claimed_path), "%s/%s/%s", dir,
+                 CLAIMED_DIR, entry->d_name);
+        snprintf(pending_path, sizeof(pending_path), "%s/%s/%s", dir,
+                 PENDING_DIR, entry->d_name);
+        if (stat(claimed_path, &info) == 0 &&
+            now - info.st_mtime > lease_seconds) {
+            rename(claimed_path, pending_path);
+        }
+    }
+    closedir(claimed);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Moves a pending shard into claimed/, and starts its lease. Returns the
+   shard number, or NO_SHARD if no shard could be claimed.
+*/
+static int
+claim_shard(const char *dir) {
+    char path[PATH_MAX], pending_path[PATH_MAX], claimed_path[PATH_MAX];
+    struct dirent *entry;
+    DIR *pending;
+    int shard=NO_SHARD;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, PENDING_DIR);
+    pending = opendir(path);
+    if (pending == NULL) {
+        return NO_SHARD;
+    }
+    while (shard == NO_SHARD && (entry = readdir(pending)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(pending_path, sizeof(pending_path), "%s/%s/%s", dir,
+                 PENDING_DIR, entry->d_name);
+        snprintf(claimed_path, sizeof(claimed_path), "%s/%s/%s", dir,
+                 CLAIMED_DIR, entry->d_name);
+        //another worker may have taken it since the directory was read
+        if (rename(pending_path, claimed_path) == 0) {
+            utimensat(AT_FDCWD, claimed_path, NULL, 0);
+            shard = atoi(entry->d_name);
+        }
+    }
+    closedir(pending);
+    return shard;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Counts the shards in one of the sub directories of the queue */
+static int
+count_shards(const char *dir, const char *sub_dir) {
+    char path[PATH_MAX];
+    struct dirent *entry;
+    DIR *shards;
+    int count=0;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, sub_dir);
+    shards = opendir(path);
+    if (shards == NULL) {
+        return 0;
+    }
+    while ((entry = readdir(shards)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            count++;
+        }
+    }
+    closedir(shards);
+    return count;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Searches every position of a claimed shard, and writes the results. Each
+   result line is the position, followed by the chosen action, its backed-up
+   cost and the board cost after it, or by "-" if the player has no action.
+   The lease is renewed by another thread while the shard is searched, so a
+   search longer than the lease does not send the shard to other workers.
+*/
+static int
+search_shard(const char *dir, int shard, int lease_seconds,
+             search_options_t *config, int *n_searched) {
+    char claimed_path[PATH_MAX], results_path[PATH_MAX];
+    char temp_path[PATH_MAX];
+    lease_keeper_t keeper;
+    search_result_t result;
+    game_t position;
+    FILE *in, *out;
+    char text[MOVE_TEXT_SIZE];
+
+    snprintf(claimed_path, sizeof(claimed_path), SHARD_FORMAT, dir,
+             CLAIMED_DIR, shard);
+    snprintf(results_path, sizeof(results_path), SHARD_FORMAT, dir,
+             RESULTS_DIR, shard);
+
+    //a worker whose lease ran out may have finished the shard already
+    if (file_exists(results_path)) {
+        remove(claimed_path);
+        return QUEUE_OK;
+    }
+
+    in = fopen(claimed_path, "r");
+    if (in == NULL) {
+        //taken back after an expired lease, and claimed by another worker
+        return QUEUE_OK;
+    }
+    temp_name(temp_path, dir, RESULTS_DIR, shard);
+    out = fopen(temp_path, "w");
+    if (out == NULL) {
+        fclose(in);
+        return QUEUE_ERROR_IO;
+    }
+    if (start_lease(&keeper, claimed_path, lease_seconds) != QUEUE_OK) {
+        fclose(in);
+        fclose(out);
+        remove(temp_path);
+        return QUEUE_ERROR_IO;
+    }
+    while (read_text_position(in, &position) == RECORD_OK) {
+        if (run_search(&position, config, &result) == CHECKERS_ERROR_MEMORY) {
+            //the claim stays, so the shard is tried again once it expires
+            stop_lease(&keeper);
+            fclose(in);
+            fclose(out);
+            remove(temp_path);
+            return QUEUE_ERROR_MEMORY;
+        }
+        write_text_position(out, &position);
+        if (result.status == CHECKERS_WIN) {
+            fprintf(out, " -\n");
+        } else {
+            fprintf(out, " %s %d %d\n", format_move(&result.move, text),
+                    result.score, result.board_cost);
+        }
+        *n_searched += 1;
+    }
+    stop_lease(&keeper);
+    fclose(in);
+
+    //the results appear under their final name in one step
+    if (fclose(out) != 0 || rename(temp_path, results_path) != 0) {
+        remove(temp_path);
+        return QUEUE_ERROR_IO;
+    }
+    remove(claimed_path);
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Starts a thread that renews the lease of the claimed shard RENEWALS times
+   per lease time, until stop_lease() is called
+*/
+static int
+start_lease(lease_keeper_t *keeper, const char *claimed_path,
+            int lease_seconds) {
+    keeper->claimed_path = claimed_path;
+    keeper->interval = lease_seconds/RENEWALS > 0 ? lease_seconds/RENEWALS : 1;
+    keeper->stop = FALSE;
+    pthread_mutex_init(&keeper->lock, NULL);
+    pthread_cond_init(&keeper->done, NULL);
+    if (pthread_create(&keeper->thread, NULL, keep_lease, keeper) != 0) {
+        pthread_cond_destroy(&keeper->done);
+        pthread_mutex_destroy(&keeper->lock);
+        return QUEUE_ERROR_IO;
+    }
+    return QUEUE_OK;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Stops the thread started by start_lease(), and waits for it */
+static void
+stop_lease(lease_keeper_t *keeper) {
+    pthread_mutex_lock(&keeper->lock);
+    keeper->stop = TRUE;
+    pthread_cond_signal(&keeper->done);
+    pthread_mutex_unlock(&keeper->lock);
+    pthread_join(keeper->thread, NULL);
+    pthread_cond_destroy(&keeper->done);
+    pthread_mutex_destroy(&keeper->lock);
+    return;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Body of the lease thread: touches the claimed shard every interval. A
+   worker that dies stops touching it, and its lease runs out.
+*/
+static void
+*keep_lease(void *arg) {
+    lease_keeper_t *keeper = (lease_keeper_t*)arg;
+    struct timespec wake;
+
+    pthread_mutex_lock(&keeper->lock);
+    while (!keeper->stop) {
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += keeper->interval;
+        while (!keeper->stop &&
+               pthread_cond_timedwait(&keeper->done, &keeper->lock,
+                                      &wake) == 0) {
+            //woken early, but not stopped: wait out the interval
+        }
+        if (!keeper->stop) {
+            utimensat(AT_FDCWD, keeper->claimed_path, NULL, 0);
+        }
+    }
+    pthread_mutex_unlock(&keeper->lock);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Returns TRUE if the file exists */
+static int
+file_exists(const char *path) {
+    struct stat info;
+    return stat(path, &info) == 0;
+}
+
+/* --------------------------------------------------------------------------*/
+
+/* Makes a hidden file name in the sub directory that no other process, on
+   this machine or another, will use at the same time.
+*/
+static void
+temp_name(char *path, const char *dir, const char *sub_dir, int shard) {
+    char host[HOST_SIZE];
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        strcpy(host, "host");
+    }
+    host[HOST_SIZE-1] = '\0';
+    snprintf(path, PATH_MAX, TEMP_FORMAT, dir, sub_dir, shard, host,
+             (long)getpid());
+    return;
+}
+
+/* THE END -------------------------------------------------------------------*/
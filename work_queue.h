@@ -0,0 +1,65 @@
+/* Sharded analysis through a work queue kept in a directory.
+
+   A coordinator splits a corpus of positions into shards. Any number of
+   workers, on this machine or on others sharing the file system, claim
+   shards, search every position of the shard and write the results. A
+   finished analysis is merged into one file, in shard order.
+
+   Directory layout:
+     manifest       "shards N depth D engine E playouts P seed S" once
+                    every shard has been written; every worker searches
+                    with engine E, D actions ahead, or P Monte Carlo
+                    playouts seeded with S
+     staging/NNNNNN shards being written by the coordinator; the directory
+                    goes once they are all in pending/
+     pending/NNNNNN shards waiting for a worker, one position per line
+     claimed/NNNNNN shards being searched; the modification time is the
+                    worker's lease, renewed while the worker searches it
+     results/NNNNNN the search result of every position of the shard
+
+   Every step is a rename(), so a shard is only ever claimed by one worker.
+   Workers may start as soon as the directory exists: they wait for the
+   manifest before claiming anything, and give up if the coordinator fails
+   (it then removes the queue) or stops writing for a lease time. A shard
+   whose lease is older than the lease time is put back in pending/ by the
+   next worker that looks, which is how a crashed worker's shards get
+   searched again. The manifest holds every setting a result depends on, and
+   the queue refuses the settings that make a search depend on timing (a time
+   limit or several threads for the Monte Carlo engine), so a shard searched
+   twice gives the same results twice, whichever worker searched it.
+*/
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include "search_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Definitions ------------------------------------------------------*/
+
+#define QUEUE_LEASE         60      // default lease time in seconds
+
+// results of the queue functions
+#define QUEUE_OK            0       // no error
+#define QUEUE_ERROR_IO      1       // queue or corpus could not be used
+#define QUEUE_ERROR_CORPUS  2       // corpus holds an invalid position
+#define QUEUE_NOT_FINISHED  3       // some shards have no results yet
+#define QUEUE_ERROR_MEMORY  4       // a search ran out of memory
+#define QUEUE_ERROR_OPTIONS 5       // searches would not be repeatable
+
+
+/* function prototypes ------------------------------------------------------*/
+int queue_create(const char *dir, const char *corpus_path, int shard_size,
+                 search_options_t *config, int *n_shards);
+int queue_work(const char *dir, int lease_seconds, search_options_t *config,
+               int *n_searched);
+int queue_merge(const char *dir, const char *out_path, int *n_missing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif